@@ -49,6 +49,7 @@ int main() {
 #include "aosoa/for_each.hpp"
 #include "aosoa/for_each_range.hpp"
 #include "aosoa/indexed_for_each.hpp"
+#include "aosoa/reduce.hpp"
 
 #include <ctime>
 #include <iostream>
@@ -94,17 +95,10 @@ template<typename A> void flat_update(A& a, int n) {
 template<typename A> void nested_update(A& a) {
   typedef decltype(a[0]) C;
 
-#ifdef __ICC
   aosoa::ivdep_for_each([](C& e){
 	  e.pos.x += e.vel.x;
 	  e.pos.y += e.vel.y;
 	}, a);
-#else
-  aosoa::for_each([](C& e){
-	  e.pos.x += e.vel.x;
-	  e.pos.y += e.vel.y;
-	}, a);
-#endif
 }
 
 constexpr size_t len = 100000;
@@ -160,20 +154,12 @@ template<typename A> void nested_benchmark (A& array, size_t repeat) {
 
 	nested_update(array);
 
-	float localx = 0, localy = 0;
+	const auto local = aosoa::reduce([](Point0& sum, C& e) {
+		sum.x += e.pos.x;
+		sum.y += e.pos.y;
+	  }, Point0{0, 0}, [](Point0 a, Point0 b) {return Point0{a.x+b.x, a.y+b.y};}, array);
 
-	aosoa::for_each_range([&](size_t start, size_t end,
-							  typename soa::table_traits<A>::table_reference t) {
-							float cx = 0, cy = 0;
-#pragma simd reduction(+:cx,cy)
-							for (size_t i=start; i<end; ++i) {
-							  cx += t[i].pos.x;
-							  cy += t[i].pos.y;
-							}
-							localx += cx;
-							localy += cy;
-						  },
-						  array);
+	const float localx = local.x, localy = local.y;
 
 	globalx += localx;
 	globaly += localy;
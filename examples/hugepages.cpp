@@ -0,0 +1,160 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// sweeps over 16 columns, with and without huge pages. run it under
+// "perf stat -e dTLB-loads,dTLB-load-misses" to see the TLB misses.
+
+#ifdef NVARIADIC
+
+#pragma message "16 fields not supported in the non-variadic version of the SOA library"
+
+#include <iostream>
+
+int main() {
+  std::cout << "16 fields not supported in the non-variadic version of the SOA library\n";
+}
+
+#else
+
+#include "soa/reference_type.hpp"
+#include "soa/dtable.hpp"
+#include "soa/huge_page_allocator.hpp"
+#include "soa/slab.hpp"
+
+#include "aosoa/table_vector.hpp"
+
+#include "aosoa/for_each_range.hpp"
+
+#include <chrono>
+#include <iostream>
+
+struct Row {
+  float &c0, &c1, &c2, &c3, &c4, &c5, &c6, &c7,
+	&c8, &c9, &c10, &c11, &c12, &c13, &c14, &c15;
+
+  typedef soa::reference_type<float, float, float, float, float, float, float, float,
+							  float, float, float, float, float, float, float, float> reference;
+
+  Row(const reference::type& ref) :
+	c0(reference::get<0>(ref)), c1(reference::get<1>(ref)),
+	c2(reference::get<2>(ref)), c3(reference::get<3>(ref)),
+	c4(reference::get<4>(ref)), c5(reference::get<5>(ref)),
+	c6(reference::get<6>(ref)), c7(reference::get<7>(ref)),
+	c8(reference::get<8>(ref)), c9(reference::get<9>(ref)),
+	c10(reference::get<10>(ref)), c11(reference::get<11>(ref)),
+	c12(reference::get<12>(ref)), c13(reference::get<13>(ref)),
+	c14(reference::get<14>(ref)), c15(reference::get<15>(ref))
+  {}
+};
+
+constexpr size_t len = 1 << 22;
+constexpr size_t blocksize = 1024;
+
+size_t repeat;
+
+template<typename R> inline void init(R&& r) {
+  r.c0 = r.c1 = r.c2 = r.c3 = r.c4 = r.c5 = r.c6 = r.c7 =
+	r.c8 = r.c9 = r.c10 = r.c11 = r.c12 = r.c13 = r.c14 = r.c15 = 1;
+}
+
+template<typename R> inline void sweep(R&& r) {
+  r.c0 += r.c1 + r.c2 + r.c3 + r.c4 + r.c5 + r.c6 + r.c7 +
+	r.c8 + r.c9 + r.c10 + r.c11 + r.c12 + r.c13 + r.c14 + r.c15;
+}
+
+template<typename F> void benchmark(const F& f) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r=0; r<repeat; ++r) f();
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "time: " << std::chrono::duration<double>(end-start).count() << "s\n";
+}
+
+template<typename A> void flat_benchmark(A& array) {
+  for (size_t i=0; i<len; ++i) init(array[i]);
+  benchmark([&array]{
+	  for (size_t i=0; i<len; ++i) sweep(array[i]);
+	});
+  std::cout << "result: " << array[len-1].c0 << std::endl;
+}
+
+template<typename A> void nested_benchmark(A& array) {
+  auto const initialize = [](size_t start, size_t end, typename soa::table_traits<A>::table_reference t) {
+	for (size_t i=start; i<end; ++i) init(t[i]);
+  };
+  auto const update = [](size_t start, size_t end, typename soa::table_traits<A>::table_reference t) {
+	for (size_t i=start; i<end; ++i) sweep(t[i]);
+  };
+  aosoa::for_each_range(initialize, array);
+  benchmark([&array, &update]{aosoa::for_each_range(update, array);});
+  std::cout << "result: " << array[len-1].c0 << std::endl;
+}
+
+void flatDSOA() {
+  std::cout << "\nflat dynamic SOA array\n";
+  soa::dtable<Row> array(len);
+  flat_benchmark(array);
+}
+
+void flatDSOAH() {
+  std::cout << "\nflat dynamic SOA array, huge pages\n";
+  soa::dtable<Row, soa::huge_page_allocator<char>> array(len);
+  flat_benchmark(array);
+}
+
+void flatDSOASH() {
+  std::cout << "\nflat dynamic SOA array in a slab, huge pages\n";
+  soa::dtable<Row, soa::slab<64, soa::huge_page_allocator<char>>> array(len);
+  flat_benchmark(array);
+}
+
+void nestedSOV() {
+  std::cout << "\nnested SOA vector, blocksize " << blocksize << std::endl;
+  aosoa::table_vector<Row,blocksize> array(len);
+  nested_benchmark(array);
+}
+
+void nestedSOVH() {
+  std::cout << "\nnested SOA vector, blocksize " << blocksize << ", huge pages" << std::endl;
+  aosoa::table_vector<Row,blocksize,soa::huge_page_allocator<char>> array(len);
+  nested_benchmark(array);
+}
+
+int main() {
+  std::cout << "len: " << len << std::endl;
+  std::cout << "repeat: "; std::cin >> repeat;
+
+  flatDSOA();
+  flatDSOAH();
+  flatDSOASH();
+
+  nestedSOV();
+  nestedSOVH();
+}
+
+#endif
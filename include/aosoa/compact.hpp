@@ -0,0 +1,243 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_COMPACT
+#define AOSOA_COMPACT
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+
+#include "soa/columns.hpp"
+#include "soa/dtable.hpp"
+#include "soa/no_init.hpp"
+#include "soa/table_traits.hpp"
+
+#include "aosoa/offset_table.hpp"
+
+namespace aosoa {
+
+  namespace {
+	// the elements are selected in blocks that do not cross a table
+	// boundary of the source container.
+
+	constexpr size_t _compact_block = 256;
+
+	// which elements to select: the results of a predicate, or a mask
+	// that was stored for the whole container by an earlier pass.
+
+	template<typename P>
+	class _predicate_mask {
+	private:
+	  const P& predicate;
+
+	public:
+	  _predicate_mask (const P& predicate) : predicate(predicate) {}
+
+	  template<typename Table>
+	  inline const bool* get (Table& table, size_t, size_t count, bool* buffer) const {
+		for (size_t i=0; i<count; ++i) {
+		  auto&& element = table[i];
+		  buffer[i] = predicate(element);
+		}
+		return buffer;
+	  }
+	};
+
+	template<typename P>
+	class _not_predicate {
+	private:
+	  const P& predicate;
+
+	public:
+	  _not_predicate (const P& predicate) : predicate(predicate) {}
+
+	  template<typename T>
+	  inline bool operator() (T& element) const {return !predicate(element);}
+	};
+
+	class _stored_mask {
+	private:
+	  const bool* mask;
+
+	public:
+	  _stored_mask (const bool* mask) : mask(mask) {}
+
+	  template<typename Table>
+	  inline const bool* get (Table&, size_t index, size_t, bool*) const {return mask+index;}
+	};
+
+	// copy the source elements at indices to consecutive destination
+	// elements, one column at a time.
+
+	class _gather_run {
+	private:
+	  const uint32_t* indices;
+	  size_t count;
+
+	public:
+	  _gather_run (const uint32_t* indices, size_t count) : indices(indices), count(count) {}
+
+	  template<typename T> inline void operator() (T* destination, T* source) const {
+		for (size_t i=0; i<count; ++i) destination[i] = source[indices[i]];
+	  }
+	};
+
+	template<class C, typename Table>
+	inline size_t _gather (const uint32_t* indices, size_t count, Table& source, C& destination, size_t to) {
+	  for (size_t i=0; i<count;) {
+		const size_t run = std::min(_mixed_container<C>::run(destination, to), count-i);
+		soa::for_each_column(_mixed_container<C>::table(destination, to).columns(),
+							 source.columns(), _gather_run(indices+i, run));
+		i += run;
+		to += run;
+	  }
+	  return to;
+	}
+
+	// move the selected elements of [begin, end) of source to
+	// destination, starting at index to, and return the index after
+	// them. the indices of the selected elements of a block are packed
+	// without branches, and then all columns are gathered. source and
+	// destination may be the same container, as long as to <= begin.
+
+	template<class Mask, class C0, class C1>
+	inline size_t _compact_range (const Mask& mask, size_t begin, size_t end,
+								  C0& source, C1& destination, size_t to) {
+	  std::array<bool,_compact_block> buffer;
+	  std::array<uint32_t,_compact_block> indices;
+	  for (size_t i=begin; i<end;) {
+		const size_t count = std::min(std::min(_mixed_container<C0>::run(source, i), end-i), _compact_block);
+		auto table = _mixed_container<C0>::table(source, i);
+		const bool* selected = mask.get(table, i, count, buffer.data());
+		size_t n = 0;
+		for (size_t k=0; k<count; ++k) {
+		  indices[n] = k;
+		  n += selected[k];
+		}
+		to = _gather(indices.data(), n, table, destination, to);
+		i += count;
+	  }
+	  return to;
+	}
+
+	// the same, but the elements that are not selected are moved to
+	// rest, starting at index other.
+
+	template<class Mask, class C0, class C1, class C2>
+	inline size_t _partition_range (const Mask& mask, size_t begin, size_t end,
+									C0& source, C1& destination, size_t to, C2& rest, size_t other) {
+	  std::array<bool,_compact_block> buffer;
+	  std::array<uint32_t,_compact_block> indices, others;
+	  for (size_t i=begin; i<end;) {
+		const size_t count = std::min(std::min(_mixed_container<C0>::run(source, i), end-i), _compact_block);
+		auto table = _mixed_container<C0>::table(source, i);
+		const bool* selected = mask.get(table, i, count, buffer.data());
+		size_t n = 0, m = 0;
+		for (size_t k=0; k<count; ++k) {
+		  indices[n] = k;
+		  others[m] = k;
+		  n += selected[k];
+		  m += !selected[k];
+		}
+		// gather the rest first, in case destination is source.
+		other = _gather(others.data(), m, table, rest, other);
+		to = _gather(indices.data(), n, table, destination, to);
+		i += count;
+	  }
+	  return to;
+	}
+
+	class _move_run {
+	private:
+	  size_t from, count;
+
+	public:
+	  _move_run (size_t from, size_t count) : from(from), count(count) {}
+
+	  template<typename T> inline void operator() (T* destination, T* source) const {
+		std::memcpy(destination, source+from, count*sizeof(T));
+	  }
+	};
+  }
+
+  // copy the elements of source for which predicate(element) is true
+  // to the front of destination, in order, and return their number.
+  // destination must be large enough, and is not resized. the
+  // containers must be tabled, but may have different table sizes.
+
+  template<class C0, class C1, typename P>
+  inline size_t copy_if(C0& source, C1& destination, const P& predicate)
+  {
+	static_assert(soa::table_traits<C0>::tabled && soa::table_traits<C1>::tabled,
+				  "copy_if needs tabled containers");
+	return _compact_range(_predicate_mask<P>(predicate), 0, source.size(), source, destination, 0);
+  }
+
+  // remove the elements for which predicate(element) is true, keep
+  // the order of the other elements, and resize the container once
+  // at the end. returns the new size.
+
+  template<class C, typename P>
+  inline size_t remove_if(C& container, const P& predicate)
+  {
+	static_assert(soa::table_traits<C>::tabled, "remove_if needs a tabled container");
+	const _not_predicate<P> keep(predicate);
+	const size_t size = _compact_range(_predicate_mask<_not_predicate<P>>(keep), 0, container.size(), container, container, 0);
+	container.resize(size);
+	return size;
+  }
+
+  // move the elements for which predicate(element) is true before
+  // the others, keeping the order within both groups, and return the
+  // number of elements in the first group. the second group is
+  // collected in a temporary dtable.
+
+  template<class C, typename P>
+  inline size_t stable_partition(C& container, const P& predicate)
+  {
+	static_assert(soa::table_traits<C>::tabled, "stable_partition needs a tabled container");
+	const size_t size = container.size();
+	soa::dtable<typename soa::table_traits<C>::value_type> rest(size, soa::no_init);
+	const size_t count = _partition_range(_predicate_mask<P>(predicate), 0, size, container, container, 0, rest, 0);
+	for (size_t i=count; i<size;) {
+	  const size_t run = std::min(_mixed_container<C>::run(container, i), size-i);
+	  soa::for_each_column(_mixed_container<C>::table(container, i).columns(),
+						   rest.columns(), _move_run(i-count, run));
+	  i += run;
+	}
+	return count;
+  }
+
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_COPY
+#define AOSOA_COPY
+
+#include <cstddef>
+#include <cstring>
+
+#include <algorithm>
+
+#include "soa/columns.hpp"
+#include "soa/table_traits.hpp"
+
+#ifndef NOTBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace aosoa {
+
+  namespace {
+	// copy count elements of each column, from index from in the
+	// source table to index to in the destination table.
+
+	class _copy_run {
+	private:
+	  size_t to, from, count;
+
+	public:
+	  _copy_run (size_t to, size_t from, size_t count) : to(to), from(from), count(count) {}
+
+	  template<typename T> inline void operator() (T* destination, T* source) const {
+		std::memcpy(destination+to, source+from, count*sizeof(T));
+	  }
+	};
+
+	// copy the elements [begin, end) in runs that do not cross a table
+	// boundary in either container.
+
+	template<class C0, class C1>
+	inline void _copy_range(C0& source, C1& destination, size_t begin, size_t end) {
+	  const size_t size0 = soa::table_traits<C0>::table_size;
+	  const size_t size1 = soa::table_traits<C1>::table_size;
+	  for (size_t i=begin; i<end;) {
+		const auto from = i%size0, to = i%size1;
+		const auto count = std::min(std::min(size0-from, size1-to), end-i);
+		soa::for_each_column(destination.data()[i/size1].columns(),
+							 source.data()[i/size0].columns(),
+							 _copy_run(to, from, count));
+		i += count;
+	  }
+	}
+  }
+
+  // copy the elements of source into destination, which must have at
+  // least the same size, and the same leaf fields. the containers may
+  // have different table sizes, for example to switch between a
+  // table_vector<C,8> and a table_vector<C,1024>, or between a dtable
+  // and a table_vector.
+
+  template<class C0, class C1>
+  inline void copy(C0& source, C1& destination)
+  {
+	static_assert(soa::table_traits<C0>::tabled && soa::table_traits<C1>::tabled,
+				  "copy needs tabled containers");
+	_copy_range(source, destination, 0, source.size());
+  }
+
+#ifndef NOTBB
+  // the work is split into chunks of the larger table size, which
+  // keeps the runs as long as in the sequential copy.
+
+  template<class C0, class C1>
+  inline void parallel_copy(C0& source, C1& destination)
+  {
+	static_assert(soa::table_traits<C0>::tabled && soa::table_traits<C1>::tabled,
+				  "copy needs tabled containers");
+	const size_t size0 = soa::table_traits<C0>::table_size;
+	const size_t size1 = soa::table_traits<C1>::table_size;
+	const size_t size = source.size();
+	const size_t largest = size0 == SIZE_MAX ? size1 : size1 == SIZE_MAX ? size0 : std::max(size0, size1);
+	const size_t chunk = largest == SIZE_MAX ? 4096 : largest;
+	tbb::parallel_for
+	  (tbb::blocked_range<size_t>(0, size/chunk+(size%chunk?1:0)),
+	   [&source, &destination, size, chunk](const tbb::blocked_range<size_t>& r) {
+		_copy_range(source, destination, r.begin()*chunk, std::min(r.end()*chunk, size));
+	  });
+  }
+#endif
+
+}
+
+#endif
@@ -0,0 +1,173 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_FOR_EACH_PAIR
+#define AOSOA_FOR_EACH_PAIR
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+
+#include "soa/table_traits.hpp"
+
+namespace aosoa {
+
+  namespace {
+	// the pair loops work on tiles of the containers: the tables of a
+	// tabled container, or blocks of _pair_tile elements of a dtable.
+
+	constexpr size_t _pair_tile = 1024;
+
+	template<class C>
+	class _pair_tiles {
+	private:
+	  typedef soa::table_traits<C> traits;
+	public:
+	  static constexpr size_t tile = traits::table_size == SIZE_MAX ? _pair_tile : traits::table_size;
+
+	  static inline size_t count (C& container) {
+		const size_t n = container.size();
+		return n/tile + (n%tile?1:0);
+	  }
+
+	  static inline typename traits::table_reference table (C& container, size_t t) {
+		return container.data()[t*tile/traits::table_size];
+	  }
+
+	  static inline size_t start (size_t t) {return (t*tile)%traits::table_size;}
+
+	  static inline size_t end (C& container, size_t t) {
+		return start(t) + std::min(size_t(tile), container.size()-t*tile);
+	  }
+	};
+
+	// call f(a, start, end, table) for the elements a of tile t0 of
+	// first, with the elements [start, end) of table that form tile t1
+	// of second. in the symmetric case on the diagonal, each element
+	// is only paired with the elements after it.
+
+	template<typename F, class C0, class C1>
+	inline void _pair_tile_range (const F& f, C0& first, size_t t0, C1& second, size_t t1) {
+	  typedef _pair_tiles<C0> tiles0;
+	  typedef _pair_tiles<C1> tiles1;
+	  auto&& table0 = tiles0::table(first, t0);
+	  auto&& table1 = tiles1::table(second, t1);
+	  const size_t end0 = tiles0::end(first, t0);
+	  const size_t start1 = tiles1::start(t1), end1 = tiles1::end(second, t1);
+	  for (size_t i=tiles0::start(t0); i<end0; ++i) {
+		auto&& a = table0[i];
+		f(a, start1, end1, table1);
+	  }
+	}
+
+	template<typename F, class C>
+	inline void _diagonal_tile_range (const F& f, C& container, size_t t) {
+	  typedef _pair_tiles<C> tiles;
+	  auto&& table = tiles::table(container, t);
+	  const size_t end = tiles::end(container, t);
+	  for (size_t i=tiles::start(t); i<end; ++i) {
+		auto&& a = table[i];
+		f(a, i+1, end, table);
+	  }
+	}
+
+	// turns f(a, b) into a range kernel for the pair loops.
+
+	template<typename F>
+	class _pair_elements {
+	private:
+	  const F& f;
+
+	public:
+	  _pair_elements (const F& f) : f(f) {}
+
+	  template<typename A, typename Table>
+	  inline void operator() (A& a, size_t start, size_t end, Table& table) const {
+		for (size_t j=start; j<end; ++j) {
+		  auto&& b = table[j];
+		  f(a, b);
+		}
+	  }
+	};
+  }
+
+  // call f(a, start, end, table) for all pairs of a tile of first and
+  // a tile of second, with a an element of the first tile, and the
+  // elements [start, end) of table forming the second tile. the
+  // kernel loops over the second tile, which can be vectorized, and
+  // can accumulate into the fields of a, for example in local
+  // variables. both containers must be tabled.
+
+  template<typename F, class C0, class C1>
+  inline void for_each_pair_range(const F& f, C0& first, C1& second)
+  {
+	static_assert(soa::table_traits<C0>::tabled && soa::table_traits<C1>::tabled,
+				  "for_each_pair needs tabled containers");
+	const size_t count0 = _pair_tiles<C0>::count(first);
+	const size_t count1 = _pair_tiles<C1>::count(second);
+	for (size_t t0=0; t0<count0; ++t0)
+	  for (size_t t1=0; t1<count1; ++t1)
+		_pair_tile_range(f, first, t0, second, t1);
+  }
+
+  // call f(a, b) for all elements a of first and b of second.
+
+  template<typename F, class C0, class C1>
+  inline void for_each_pair(const F& f, C0& first, C1& second)
+  {
+	for_each_pair_range(_pair_elements<F>(f), first, second);
+  }
+
+  // the symmetric versions visit every pair of different elements of
+  // a single container once, for kernels that update both elements,
+  // as with Newton's third law. the elements [start, end) of table
+  // come after a in the container.
+
+  template<typename F, class C>
+  inline void symmetric_for_each_pair_range(const F& f, C& container)
+  {
+	static_assert(soa::table_traits<C>::tabled, "for_each_pair needs a tabled container");
+	const size_t count = _pair_tiles<C>::count(container);
+	for (size_t t0=0; t0<count; ++t0) {
+	  _diagonal_tile_range(f, container, t0);
+	  for (size_t t1=t0+1; t1<count; ++t1)
+		_pair_tile_range(f, container, t0, container, t1);
+	}
+  }
+
+  template<typename F, class C>
+  inline void symmetric_for_each_pair(const F& f, C& container)
+  {
+	symmetric_for_each_pair_range(_pair_elements<F>(f), container);
+  }
+
+}
+
+#endif
@@ -0,0 +1,231 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_GATHER
+#define AOSOA_GATHER
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "soa/columns.hpp"
+#include "soa/table_traits.hpp"
+
+#include "aosoa/apply_tuple.hpp"
+#include "aosoa/offset_table.hpp"
+
+// the number of indices that the indirect loops look ahead to issue
+// software prefetches. 0 disables the prefetches.
+
+#ifndef AOSOA_PREFETCH_DISTANCE
+#define AOSOA_PREFETCH_DISTANCE 16
+#endif
+
+namespace aosoa {
+
+  namespace {
+	constexpr size_t _prefetch_distance = AOSOA_PREFETCH_DISTANCE;
+
+	template<int rw, typename T>
+	inline void _prefetch (const T* address) {
+#if defined(__GNUC__) || defined(__clang__) || defined(__ICC)
+	  __builtin_prefetch(address, rw, 3);
+#else
+	  (void)address;
+#endif
+	}
+
+	template<int rw>
+	class _prefetch_column {
+	private:
+	  size_t lane;
+
+	public:
+	  _prefetch_column (size_t lane) : lane(lane) {}
+
+	  template<typename T> inline void operator() (T* column) const {_prefetch<rw>(column+lane);}
+	};
+
+	// element index of a container in an indirect loop: the table and
+	// the lane of the element are computed once, and then only the
+	// columns that are used are accessed. untabled containers are
+	// accessed through their iterators.
+
+	template<class C, bool tabled = soa::table_traits<C>::tabled> class _indirect;
+
+	template<class C> class _indirect<C, true> {
+	private:
+	  typedef soa::table_traits<C> traits;
+	public:
+	  static inline auto element (C& container, size_t index)
+		-> decltype(container.data()[0][0])
+	  {
+		const size_t size = traits::table_size;
+		return container.data()[index/size][index%size];
+	  }
+
+	  // when data() is a plain pointer, the tables are contiguous, so
+	  // the address of an element is linear in its table and lane,
+	  // which lets the compiler use hardware gathers for loops over
+	  // column. otherwise, for example for a table_deque, the table is
+	  // looked up through data().
+
+	  template<size_t I>
+	  static inline typename _column_type<C,I>::type* column (C& container, size_t index) {
+		return column<I>(container, index, std::is_pointer<decltype(container.data())>());
+	  }
+
+	  template<size_t I>
+	  static inline typename _column_type<C,I>::type* column (C& container, size_t index, std::true_type) {
+		typedef typename _column_type<C,I>::type T;
+		typedef typename std::remove_reference<typename traits::table_reference>::type table_type;
+		const size_t size = traits::table_size;
+		char* const base = reinterpret_cast<char*>(std::get<I>(container.data()[0].columns()));
+		return reinterpret_cast<T*>(base + (index/size)*sizeof(table_type) + (index%size)*sizeof(T));
+	  }
+
+	  template<size_t I>
+	  static inline typename _column_type<C,I>::type* column (C& container, size_t index, std::false_type) {
+		const size_t size = traits::table_size;
+		return std::get<I>(container.data()[index/size].columns()) + index%size;
+	  }
+
+	  template<int rw>
+	  static inline void prefetch (C& container, size_t index) {
+		const size_t size = traits::table_size;
+		soa::for_each_column(container.data()[index/size].columns(), _prefetch_column<rw>(index%size));
+	  }
+	};
+
+	template<class C> class _indirect<C, false> {
+	public:
+	  static inline auto element (C& container, size_t index) -> decltype(*container.begin()) {
+		return container.begin()[index];
+	  }
+
+	  template<int rw>
+	  static inline void prefetch (C& container, size_t index) {
+		_prefetch<rw>(&container.begin()[index]);
+	  }
+	};
+
+	template<int rw, class... CN>
+	inline void _prefetch_elements (size_t index, CN&... containers) {
+	  int prefetches[] = {0, (_indirect<CN>::template prefetch<rw>(containers, index), 0)...};
+	  (void)prefetches;
+	}
+
+	// evaluates an access for each column. unlike an array
+	// initializer, this does not keep the loops from being vectorized.
+
+	template<typename... T> inline void _columnwise (T&&...) {}
+
+	// the loop over the index list of indirect_for_each, which issues
+	// the prefetches for the index that is _prefetch_distance ahead.
+	// the operands are passed on to prefetch and f. gather and scatter
+	// have their own loops, so that their arrays are restrict pointers
+	// in the loops.
+
+	template<typename Indices, typename Prefetch, typename F, typename... TN>
+	inline void _indirect_loop (const Indices& indices, const Prefetch& prefetch, const F& f, TN&&... operands) {
+	  const size_t n = indices.size();
+	  size_t k = 0;
+	  if (_prefetch_distance)
+		for (; k+_prefetch_distance<n; ++k) {
+		  prefetch(indices[k+_prefetch_distance], operands...);
+		  f(indices[k], operands...);
+		}
+	  for (; k<n; ++k) f(indices[k], operands...);
+	}
+  }
+
+  // copy leaf columns I... of the elements indices[k] of a tabled
+  // container to out[k], with one output array per column. indices
+  // can be any random-access container of element indices. for
+  // containers with contiguous tables, the loop can be vectorized
+  // with hardware gather instructions, for example with AVX2 or
+  // AVX-512.
+
+  template<size_t... I, class C, class Indices, typename... T>
+  inline void gather(C& container, const Indices& indices, T* __restrict... out)
+  {
+	static_assert(soa::table_traits<C>::tabled, "gather needs a tabled container");
+	static_assert(sizeof...(I) == sizeof...(T), "gather needs an output array per column");
+	const size_t n = indices.size();
+	size_t k = 0;
+	if (_prefetch_distance)
+	  for (; k+_prefetch_distance<n; ++k) {
+		_columnwise((_prefetch<0>(_indirect<C>::template column<I>(container, indices[k+_prefetch_distance])), 0)...);
+		_columnwise((out[k] = *_indirect<C>::template column<I>(container, indices[k]))...);
+	  }
+	for (; k<n; ++k)
+	  _columnwise((out[k] = *_indirect<C>::template column<I>(container, indices[k]))...);
+  }
+
+  // copy in[k] to leaf columns I... of the elements indices[k] of a
+  // tabled container. when an index occurs more than once, the last
+  // value is stored.
+
+  template<size_t... I, class C, class Indices, typename... T>
+  inline void scatter(C& container, const Indices& indices, const T* __restrict... in)
+  {
+	static_assert(soa::table_traits<C>::tabled, "scatter needs a tabled container");
+	static_assert(sizeof...(I) == sizeof...(T), "scatter needs an input array per column");
+	const size_t n = indices.size();
+	size_t k = 0;
+	if (_prefetch_distance)
+	  for (; k+_prefetch_distance<n; ++k) {
+		_columnwise((_prefetch<1>(_indirect<C>::template column<I>(container, indices[k+_prefetch_distance])), 0)...);
+		_columnwise((*_indirect<C>::template column<I>(container, indices[k]) = in[k])...);
+	  }
+	for (; k<n; ++k)
+	  _columnwise((*_indirect<C>::template column<I>(container, indices[k]) = in[k])...);
+  }
+
+  // call f for the elements indices[k] of the containers, in the
+  // order of the index list, for example for the neighbours of a
+  // particle. the elements are prefetched in all columns. this is
+  // random access, so unlike the other loops, it does not pass sweep
+  // hints to the containers.
+
+  template<typename F, class Indices, class C, class... CN>
+  inline void indirect_for_each(const F& f, const Indices& indices, C& first, CN&... rest)
+  {
+	_indirect_loop
+	  (indices,
+	   [](size_t index, C& first, CN&... rest) {_prefetch_elements<0>(index, first, rest...);},
+	   [&f](size_t index, C& first, CN&... rest) {
+		apply_tuple(f, std::forward_as_tuple(_indirect<C>::element(first, index),
+											 _indirect<CN>::element(rest, index)...));
+	  }, first, rest...);
+  }
+
+}
+
+#endif
@@ -35,6 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "soa/table_traits.hpp"
 
+#include "aosoa/offset_table.hpp"
 #include "aosoa/table_iterator.hpp"
 
 namespace aosoa {
@@ -66,6 +67,15 @@ namespace aosoa {
 		f(0, first.end()-first.begin(), 0, first.begin(), rest.begin()...);
 	  }
 	};
+
+	template<class C, class... CN>
+	class _mixed_indexed_for_each_range {
+	public:
+	  template<typename F>
+	  static inline void loop(const F& f, C& first, CN&... rest) {
+		_indexed_mixed_range(f, 0, first.size(), first, rest...);
+	  }
+	};
   }
 
   template<typename F, class C, class... CN>
@@ -74,7 +84,10 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_indexed_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>::
+	soa::sweep_hints(first, rest...);
+	std::conditional<soa::is_mixed_tabled<C, CN...>::value,
+					 _mixed_indexed_for_each_range<C, CN...>,
+					 _indexed_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>>::type::
 	  loop(f, first, rest...);
   }
 
@@ -112,6 +125,15 @@ namespace aosoa {
 		f(0, end-begin, 0, begin, others...);
 	  }
 	};
+
+	template<typename T, typename... TN>
+	class _mixed_indexed_for_each_range_it {
+	public:
+	  template<typename F>
+	  static inline void loop(T begin, T end, const F& f, TN... others) {
+		_indexed_mixed_range_it(f, 0, end-begin, begin, others...);
+	  }
+	};
   }
 
   template<typename F, typename T, typename... TN>
@@ -120,7 +142,9 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_indexed_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>::
+	std::conditional<is_mixed_tabled_iterator<T, TN...>::value,
+					 _mixed_indexed_for_each_range_it<T, TN...>,
+					 _indexed_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>>::type::
 	  loop(begin, end, f, others...);
   }
 
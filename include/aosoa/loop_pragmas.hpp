@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_LOOP_PRAGMAS
+#define AOSOA_LOOP_PRAGMAS
+
+#include "soa/table_traits.hpp"
+
+// the loop pragmas used by the vector_, ivdep_, vector_ivdep_, simd_
+// and novector_ loop variants, for the compilers that have an
+// equivalent. without one, a pragma expands to nothing.
+//
+// omp simd is only used when OpenMP is enabled, or when
+// AOSOA_OPENMP_SIMD is defined, for example together with
+// -fopenmp-simd, which does not define _OPENMP.
+
+#if defined(_OPENMP) || defined(AOSOA_OPENMP_SIMD)
+#define AOSOA_HAS_OMP_SIMD
+#endif
+
+#if defined(__ICC)
+
+#define AOSOA_PRAGMA_VECTOR_ALWAYS _Pragma("vector always")
+#define AOSOA_PRAGMA_IVDEP _Pragma("ivdep")
+#define AOSOA_PRAGMA_VECTOR_IVDEP _Pragma("ivdep") _Pragma("vector always")
+#define AOSOA_PRAGMA_SIMD _Pragma("simd")
+#define AOSOA_PRAGMA_NOVECTOR _Pragma("novector")
+
+#elif defined(__clang__)
+
+#define AOSOA_PRAGMA_VECTOR_ALWAYS _Pragma("clang loop vectorize(enable)")
+#define AOSOA_PRAGMA_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#define AOSOA_PRAGMA_VECTOR_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#ifdef AOSOA_HAS_OMP_SIMD
+#define AOSOA_PRAGMA_SIMD _Pragma("omp simd")
+#else
+#define AOSOA_PRAGMA_SIMD _Pragma("clang loop vectorize(assume_safety) interleave(enable)")
+#endif
+#define AOSOA_PRAGMA_NOVECTOR _Pragma("clang loop vectorize(disable)")
+
+#elif defined(__GNUC__) && (GCC_VERSION >= 40900)
+
+// GCC has no per-loop override of its cost model, so vector always
+// has no equivalent.
+#define AOSOA_PRAGMA_VECTOR_ALWAYS
+#define AOSOA_PRAGMA_IVDEP _Pragma("GCC ivdep")
+#ifdef AOSOA_HAS_OMP_SIMD
+#define AOSOA_PRAGMA_VECTOR_IVDEP _Pragma("omp simd")
+#define AOSOA_PRAGMA_SIMD _Pragma("omp simd")
+#else
+#define AOSOA_PRAGMA_VECTOR_IVDEP _Pragma("GCC ivdep")
+#define AOSOA_PRAGMA_SIMD _Pragma("GCC ivdep")
+#endif
+#if (GCC_VERSION >= 140000)
+#define AOSOA_PRAGMA_NOVECTOR _Pragma("GCC novector")
+#else
+#define AOSOA_PRAGMA_NOVECTOR
+#endif
+
+#else
+
+#define AOSOA_PRAGMA_VECTOR_ALWAYS
+#define AOSOA_PRAGMA_IVDEP
+#define AOSOA_PRAGMA_VECTOR_IVDEP
+#define AOSOA_PRAGMA_SIMD
+#define AOSOA_PRAGMA_NOVECTOR
+
+#endif
+
+#endif
@@ -0,0 +1,279 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_OFFSET_TABLE
+#define AOSOA_OFFSET_TABLE
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "soa/columns.hpp"
+#include "soa/table_traits.hpp"
+
+#include "aosoa/table_iterator.hpp"
+
+namespace aosoa {
+
+  namespace {
+	class _offset_column {
+	private:
+	  size_t offset;
+
+	public:
+	  _offset_column (size_t offset) : offset(offset) {}
+
+	  template<typename T> inline void operator() (T*& column) const {
+		column += offset;
+	  }
+	};
+  }
+
+  // a table with an offset: element i of an offset table is element
+  // i+offset of the underlying table. the range loops pass offset
+  // tables when the containers have different table sizes, so that
+  // the same index addresses corresponding elements in each of them.
+
+  template<class T>
+  class offset_table {
+  public:
+	typedef T table_type;
+	typedef decltype(std::declval<T&>()[0]) value_type;
+
+  private:
+	T* table;
+	size_t offset;
+
+  public:
+	offset_table (T& table, size_t offset) : table(&table), offset(offset) {}
+
+	inline value_type operator[] (size_t pos) const {return (*table)[pos+offset];}
+
+	inline T& base () const {return *table;}
+	inline size_t base_offset () const {return offset;}
+
+	// the column pointers of the underlying table, shifted by the offset.
+	inline auto columns () const -> decltype(std::declval<T&>().columns()) {
+	  auto result = table->columns();
+	  soa::for_each_column(result, _offset_column(offset));
+	  return result;
+	}
+  };
+
+  // the type that the container range loops pass to f for the tables
+  // of container T, when they loop over the containers CN: a
+  // table_reference, or an offset_table when the containers are not
+  // compatibly tabled, but some of them are tabled. untabled
+  // containers are always passed as iterators.
+
+  template<class T, class... CN> class range_table_reference {
+  private:
+	typedef soa::table_traits<T> traits;
+	typedef typename traits::table_reference table_reference;
+  public:
+	typedef typename std::conditional<soa::is_mixed_tabled<CN...>::value && traits::tabled,
+									  offset_table<typename std::remove_reference<table_reference>::type>,
+									  table_reference>::type type;
+  };
+
+  // the same for the iterator range loops.
+
+  template<typename T, typename... TN> class range_iterator_table_reference {
+  private:
+	typedef table_iterator_traits<T> traits;
+	typedef typename traits::table_reference table_reference;
+  public:
+	typedef typename std::conditional<is_mixed_tabled_iterator<TN...>::value && traits::tabled,
+									  offset_table<typename std::remove_reference<table_reference>::type>,
+									  table_reference>::type type;
+  };
+
+  namespace {
+	// the element type of leaf column N of container C.
+
+	template<class C, size_t N>
+	class _column_type {
+	private:
+	  typedef typename std::remove_reference<typename soa::table_traits<C>::table_reference>::type table_type;
+	public:
+	  typedef typename std::remove_pointer<typename std::tuple_element<N, typename table_type::columns_type>::type>::type type;
+	};
+
+	// element index of a container or iterator operand, as a table
+	// and an offset into that table. untabled operands have no table
+	// boundaries, and are passed as iterators.
+
+	template<class C, bool tabled = soa::table_traits<C>::tabled> class _mixed_container;
+
+	template<class C> class _mixed_container<C, true> {
+	private:
+	  typedef soa::table_traits<C> traits;
+	public:
+	  static constexpr size_t table_size = traits::table_size;
+
+	  static inline size_t run (C&, size_t index) {
+		const size_t size = traits::table_size;
+		return size - index%size;
+	  }
+
+	  static inline offset_table<typename std::remove_reference<typename traits::table_reference>::type>
+	  table (C& container, size_t index) {
+		const size_t size = traits::table_size;
+		typedef typename std::remove_reference<typename traits::table_reference>::type table_type;
+		return offset_table<table_type>(container.data()[index/size], index%size);
+	  }
+	};
+
+	template<class C> class _mixed_container<C, false> {
+	public:
+	  static constexpr size_t table_size = SIZE_MAX;
+
+	  static inline size_t run (C&, size_t) {return SIZE_MAX;}
+
+	  static inline typename soa::table_traits<C>::table_reference
+	  table (C& container, size_t index) {return container.begin()+index;}
+	};
+
+	template<typename T, bool tabled = table_iterator_traits<T>::tabled> class _mixed_iterator;
+
+	template<typename T> class _mixed_iterator<T, true> {
+	private:
+	  typedef table_iterator_traits<T> traits;
+	public:
+	  static constexpr size_t table_size = traits::table_size;
+
+	  static inline size_t run (T it, size_t index) {
+		const size_t size = traits::table_size;
+		return size - (it.index+index)%size;
+	  }
+
+	  static inline offset_table<typename traits::table_type> table (T it, size_t index) {
+		const size_t size = traits::table_size;
+		const size_t pos = it.index+index;
+		return offset_table<typename traits::table_type>(it.table[pos/size], pos%size);
+	  }
+	};
+
+	template<typename T> class _mixed_iterator<T, false> {
+	public:
+	  static constexpr size_t table_size = SIZE_MAX;
+
+	  static inline size_t run (T, size_t) {return SIZE_MAX;}
+
+	  static inline T table (T it, size_t index) {return it+index;}
+	};
+
+	// runs of elements that do not cross a table boundary in any of
+	// the operands.
+
+	inline size_t _mixed_run (size_t) {return SIZE_MAX;}
+
+	template<class C, class... CN>
+	inline size_t _mixed_run (size_t index, C& container, CN&... rest) {
+	  return std::min(_mixed_container<C>::run(container, index), _mixed_run(index, rest...));
+	}
+
+	inline size_t _mixed_run_it (size_t) {return SIZE_MAX;}
+
+	template<typename T, typename... TN>
+	inline size_t _mixed_run_it (size_t index, T it, TN... rest) {
+	  return std::min(_mixed_iterator<T>::run(it, index), _mixed_run_it(index, rest...));
+	}
+
+	template<typename F, class... CN>
+	inline void _mixed_range (const F& f, size_t begin, size_t end, CN&... containers) {
+	  for (size_t i=begin; i<end;) {
+		const auto count = std::min(end-i, _mixed_run(i, containers...));
+		f(0, count, _mixed_container<CN>::table(containers, i)...);
+		i += count;
+	  }
+	}
+
+	template<typename F, class... CN>
+	inline void _indexed_mixed_range (const F& f, size_t begin, size_t end, CN&... containers) {
+	  for (size_t i=begin; i<end;) {
+		const auto count = std::min(end-i, _mixed_run(i, containers...));
+		f(0, count, i, _mixed_container<CN>::table(containers, i)...);
+		i += count;
+	  }
+	}
+
+	template<typename F, typename... TN>
+	inline void _mixed_range_it (const F& f, size_t begin, size_t end, TN... its) {
+	  for (size_t i=begin; i<end;) {
+		const auto count = std::min(end-i, _mixed_run_it(i, its...));
+		f(0, count, _mixed_iterator<TN>::table(its, i)...);
+		i += count;
+	  }
+	}
+
+	template<typename F, typename... TN>
+	inline void _indexed_mixed_range_it (const F& f, size_t begin, size_t end, TN... its) {
+	  for (size_t i=begin; i<end;) {
+		const auto count = std::min(end-i, _mixed_run_it(i, its...));
+		f(0, count, i, _mixed_iterator<TN>::table(its, i)...);
+		i += count;
+	  }
+	}
+
+	// the parallel loops split the range into chunks of the least
+	// common multiple of the table sizes, or of the largest table size
+	// if that is too large.
+
+	inline size_t _gcd (size_t a, size_t b) {return b ? _gcd(b, a%b) : a;}
+
+	inline size_t _mixed_chunk_size (size_t chunk) {return chunk;}
+
+	template<typename... SN>
+	inline size_t _mixed_chunk_size (size_t chunk, size_t size, SN... sizes) {
+	  if (size != SIZE_MAX) {
+		const auto lcm = chunk/_gcd(chunk, size)*size;
+		chunk = lcm <= 65536 ? lcm : std::max(chunk, size);
+	  }
+	  return _mixed_chunk_size(chunk, sizes...);
+	}
+
+	template<class... CN>
+	inline size_t _mixed_chunk (CN&...) {
+	  return _mixed_chunk_size(1, size_t(_mixed_container<CN>::table_size)...);
+	}
+
+	template<typename... TN>
+	inline size_t _mixed_chunk_it (TN...) {
+	  return _mixed_chunk_size(1, size_t(_mixed_iterator<TN>::table_size)...);
+	}
+  }
+
+}
+
+#endif
@@ -0,0 +1,189 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_PACK_FOR_EACH
+#define AOSOA_PACK_FOR_EACH
+
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "soa/columns.hpp"
+#include "soa/simd.hpp"
+#include "soa/table_traits.hpp"
+
+#include "aosoa/for_each_range.hpp"
+#include "aosoa/parallel_for_each_range.hpp"
+
+namespace aosoa {
+
+  namespace {
+	template<typename T, size_t W> class _simd_columns;
+
+	template<typename... T, size_t W> class _simd_columns<std::tuple<T*...>, W> {
+	public:
+	  typedef std::tuple<soa::simd<T,W>...> type;
+	};
+  }
+
+  // W consecutive elements of a tabled container C, as one simd per
+  // leaf field of C. get<N>() returns the simd of the N-th leaf field,
+  // in the order in which the fields are declared.
+
+  template<class C, size_t W>
+  class pack {
+  public:
+	typedef typename std::remove_reference<typename soa::table_traits<C>::table_reference>::type table_type;
+	typedef typename table_type::columns_type columns_type;
+	typedef typename _simd_columns<columns_type, W>::type values_type;
+
+	static constexpr size_t width = W;
+
+	values_type values;
+
+	template<size_t N>
+	inline typename std::tuple_element<N, values_type>::type& get () {
+	  return std::get<N>(values);
+	}
+
+	template<size_t N>
+	inline const typename std::tuple_element<N, values_type>::type& get () const {
+	  return std::get<N>(values);
+	}
+  };
+
+  namespace {
+	class _pack_load {
+	private:
+	  size_t index, count;
+
+	public:
+	  _pack_load (size_t index, size_t count) : index(index), count(count) {}
+
+	  template<typename T, size_t W>
+	  inline void operator() (T* column, soa::simd<T,W>& value) const {
+		if (count == W) value = soa::simd<T,W>::load(column+index);
+		else value = soa::simd<T,W>::load(column+index, count);
+	  }
+	};
+
+	class _pack_store {
+	private:
+	  size_t index, count;
+
+	public:
+	  _pack_store (size_t index, size_t count) : index(index), count(count) {}
+
+	  template<typename T, size_t W>
+	  inline void operator() (T* column, const soa::simd<T,W>& value) const {
+		if (count == W) value.store(column+index);
+		else value.store(column+index, count);
+	  }
+	};
+
+	// the columns of one table, and the pack that is loaded from them.
+
+	template<class C, size_t W>
+	class _pack_cursor {
+	  static_assert(soa::table_traits<C>::tabled, "pack_for_each needs tabled containers");
+
+	public:
+	  typename pack<C,W>::columns_type columns;
+	  pack<C,W> values;
+
+	  _pack_cursor (const typename pack<C,W>::columns_type& columns) : columns(columns) {}
+
+	  inline int load (size_t index, size_t count) {
+		soa::for_each_column(columns, values.values, _pack_load(index, count));
+		return 0;
+	  }
+
+	  inline int store (size_t index, size_t count) {
+		soa::for_each_column(columns, values.values, _pack_store(index, count));
+		return 0;
+	  }
+	};
+
+	inline void _pack_swallow (std::initializer_list<int>) {}
+
+	// the range functor passed to for_each_range: walks the range in
+	// steps of W elements, loading the packs of all containers before
+	// calling f, and storing them back afterwards. the last step of a
+	// range may be partial, and is masked.
+
+	template<size_t W, typename F, class... CN>
+	class _pack_range {
+	private:
+	  const F& f;
+
+	  template<class... Cursors>
+	  inline void run (size_t start, size_t end, Cursors... cursors) const {
+		for (size_t i=start; i<end; i+=W) {
+		  const size_t count = end-i < W ? end-i : W;
+		  _pack_swallow({cursors.load(i, count)...});
+		  f(cursors.values...);
+		  _pack_swallow({cursors.store(i, count)...});
+		}
+	  }
+
+	public:
+	  _pack_range (const F& f) : f(f) {}
+
+	  template<typename... T>
+	  inline void operator() (size_t start, size_t end, T&&... tables) const {
+		run(start, end, _pack_cursor<CN,W>(tables.columns())...);
+	  }
+	};
+  }
+
+  // call f on packs of W consecutive elements of the containers, one
+  // pack<C,W>& per container. the containers must be tabled, but may
+  // have different table sizes. the packs at the end of each table
+  // may be only partially filled, in which case the remaining
+  // elements are zero on entry, and are not stored back.
+
+  template<size_t W, typename F, class C, class... CN>
+  inline void pack_for_each(const F& f, C& first, CN&... rest)
+  {
+	for_each_range(_pack_range<W, F, C, CN...>(f), first, rest...);
+  }
+
+#ifndef NOTBB
+  template<size_t W, typename F, class C, class... CN>
+  inline void parallel_pack_for_each(const F& f, C& first, CN&... rest)
+  {
+	parallel_for_each_range(_pack_range<W, F, C, CN...>(f), first, rest...);
+  }
+#endif
+
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_PARALLEL_COMPACT
+#define AOSOA_PARALLEL_COMPACT
+
+#include <cstddef>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "soa/no_init.hpp"
+#include "soa/table_traits.hpp"
+
+#include "aosoa/compact.hpp"
+#include "aosoa/offset_table.hpp"
+#include "aosoa/reduce.hpp"
+
+#ifndef NOTBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace aosoa {
+
+#ifndef NOTBB
+  namespace {
+	// the first pass of the parallel compactions evaluates the
+	// predicate for fixed chunks in parallel, stores the results in a
+	// mask, and counts the selected elements of each chunk. the counts
+	// are then scanned to the offsets of the chunks in the result.
+
+	class _compact_chunks {
+	public:
+	  const size_t size, chunk, chunks;
+	  std::unique_ptr<bool[]> mask;
+	  std::vector<size_t> offsets;
+
+	  template<class C, typename P>
+	  _compact_chunks (C& source, const P& predicate) :
+		size(source.size()),
+		chunk(_reduce_chunk(_reduce_grainsize, source)),
+		chunks((size+chunk-1)/chunk),
+		mask(new bool[size]),
+		offsets(chunks+1, 0)
+	  {
+		bool* const selected = mask.get();
+		size_t* const counts = offsets.data()+1;
+		tbb::parallel_for
+		  (tbb::blocked_range<size_t>(0, chunks),
+		   [this, &source, &predicate, selected, counts](const tbb::blocked_range<size_t>& r) {
+			for (size_t i=r.begin(); i<r.end(); ++i) {
+			  const size_t end = std::min((i+1)*chunk, size);
+			  size_t count = 0;
+			  for (size_t j=i*chunk; j<end;) {
+				const size_t run = std::min(_mixed_container<C>::run(source, j), end-j);
+				auto table = _mixed_container<C>::table(source, j);
+				for (size_t k=0; k<run; ++k) {
+				  auto&& element = table[k];
+				  count += (selected[j+k] = predicate(element));
+				}
+				j += run;
+			  }
+			  counts[i] = count;
+			}
+		  });
+		for (size_t i=0; i<chunks; ++i) offsets[i+1] += offsets[i];
+	  }
+
+	  inline size_t begin (size_t i) const {return i*chunk;}
+	  inline size_t end (size_t i) const {return std::min((i+1)*chunk, size);}
+	  inline size_t count () const {return offsets[chunks];}
+	};
+
+	template<class C0, class C1>
+	inline void _parallel_compact (const _compact_chunks& chunks, C0& source, C1& destination) {
+	  const _compact_chunks* const c = &chunks;
+	  tbb::parallel_for
+		(tbb::blocked_range<size_t>(0, chunks.chunks),
+		 [&source, &destination, c](const tbb::blocked_range<size_t>& r) {
+		  for (size_t i=r.begin(); i<r.end(); ++i)
+			_compact_range(_stored_mask(c->mask.get()), c->begin(i), c->end(i),
+						   source, destination, c->offsets[i]);
+		});
+	}
+  }
+
+  // parallel versions of copy_if, remove_if, and stable_partition.
+  // the chunks cannot be compacted in place in parallel, so
+  // remove_if and stable_partition build the result in a new
+  // container of the same type, which is then swapped with the
+  // original one. the container type must be constructible with
+  // soa::no_init, as table_vector and dtable are.
+
+  template<class C0, class C1, typename P>
+  inline size_t parallel_copy_if(C0& source, C1& destination, const P& predicate)
+  {
+	static_assert(soa::table_traits<C0>::tabled && soa::table_traits<C1>::tabled,
+				  "copy_if needs tabled containers");
+	const _compact_chunks chunks(source, predicate);
+	_parallel_compact(chunks, source, destination);
+	return chunks.count();
+  }
+
+  template<class C, typename P>
+  inline size_t parallel_remove_if(C& container, const P& predicate)
+  {
+	static_assert(soa::table_traits<C>::tabled, "remove_if needs a tabled container");
+	const _compact_chunks chunks(container, _not_predicate<P>(predicate));
+	C result(chunks.count(), soa::no_init);
+	_parallel_compact(chunks, container, result);
+	std::swap(container, result);
+	return chunks.count();
+  }
+
+  template<class C, typename P>
+  inline size_t parallel_stable_partition(C& container, const P& predicate)
+  {
+	static_assert(soa::table_traits<C>::tabled, "stable_partition needs a tabled container");
+	const _compact_chunks chunks(container, predicate);
+	C result(chunks.size, soa::no_init);
+	const _compact_chunks* const c = &chunks;
+	const size_t count = chunks.count();
+	tbb::parallel_for
+	  (tbb::blocked_range<size_t>(0, chunks.chunks),
+	   [&container, &result, c, count](const tbb::blocked_range<size_t>& r) {
+		for (size_t i=r.begin(); i<r.end(); ++i)
+		  _partition_range(_stored_mask(c->mask.get()), c->begin(i), c->end(i), container,
+						   result, c->offsets[i], result, count + c->begin(i) - c->offsets[i]);
+	  });
+	std::swap(container, result);
+	return count;
+  }
+#endif
+
+}
+
+#endif
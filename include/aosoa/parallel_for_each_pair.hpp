@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_PARALLEL_FOR_EACH_PAIR
+#define AOSOA_PARALLEL_FOR_EACH_PAIR
+
+#include <cstddef>
+
+#include <algorithm>
+
+#include "soa/table_traits.hpp"
+
+#include "aosoa/for_each_pair.hpp"
+
+#ifndef NOTBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace aosoa {
+
+#ifndef NOTBB
+  // parallel versions of the pair loops. the tiles of first are
+  // distributed over the tasks, and every task pairs its tiles with
+  // all tiles of second, so that only one task updates an element of
+  // first, and no atomics are needed.
+
+  template<typename F, class C0, class C1>
+  inline void parallel_for_each_pair_range(const F& f, C0& first, C1& second)
+  {
+	static_assert(soa::table_traits<C0>::tabled && soa::table_traits<C1>::tabled,
+				  "for_each_pair needs tabled containers");
+	const size_t count1 = _pair_tiles<C1>::count(second);
+	tbb::parallel_for
+	  (tbb::blocked_range<size_t>(0, _pair_tiles<C0>::count(first)),
+	   [&f, &first, &second, count1](const tbb::blocked_range<size_t>& r) {
+		for (size_t t0=r.begin(); t0<r.end(); ++t0)
+		  for (size_t t1=0; t1<count1; ++t1)
+			_pair_tile_range(f, first, t0, second, t1);
+	  });
+  }
+
+  template<typename F, class C0, class C1>
+  inline void parallel_for_each_pair(const F& f, C0& first, C1& second)
+  {
+	parallel_for_each_pair_range(_pair_elements<F>(f), first, second);
+  }
+
+  // the symmetric versions group consecutive tiles into blocks of
+  // about _pair_tile elements. they first process the pairs within
+  // each block in parallel, and then the pairs of blocks in rounds of
+  // a round robin tournament, where no two pairs in the same round
+  // share a block. each round runs in parallel, so that both elements
+  // of a pair can be updated without atomics, and the blocks keep the
+  // number of rounds small and the work per round large.
+
+  template<typename F, class C>
+  inline void parallel_symmetric_for_each_pair_range(const F& f, C& container)
+  {
+	static_assert(soa::table_traits<C>::tabled, "for_each_pair needs a tabled container");
+	const size_t count = _pair_tiles<C>::count(container);
+	const size_t block = std::max(size_t(1), _pair_tile/_pair_tiles<C>::tile);
+	const size_t blocks = count/block + (count%block?1:0);
+	tbb::parallel_for
+	  (tbb::blocked_range<size_t>(0, blocks),
+	   [&f, &container, count, block](const tbb::blocked_range<size_t>& r) {
+		for (size_t b=r.begin(); b<r.end(); ++b) {
+		  const size_t end = std::min(count, (b+1)*block);
+		  for (size_t t0=b*block; t0<end; ++t0) {
+			_diagonal_tile_range(f, container, t0);
+			for (size_t t1=t0+1; t1<end; ++t1)
+			  _pair_tile_range(f, container, t0, container, t1);
+		  }
+		}
+	  });
+
+	// with an odd number of blocks, one block sits out each round.
+	const size_t players = blocks + blocks%2;
+	for (size_t round=0; round+1<players; ++round)
+	  tbb::parallel_for
+		(tbb::blocked_range<size_t>(0, players/2),
+		 [&f, &container, count, block, blocks, players, round](const tbb::blocked_range<size_t>& r) {
+		  for (size_t k=r.begin(); k<r.end(); ++k) {
+			const size_t p = k == 0 ? players-1 : (round+k)%(players-1);
+			const size_t q = k == 0 ? round : (round+players-1-k)%(players-1);
+			if (p < blocks && q < blocks) {
+			  const size_t b0 = std::min(p, q), b1 = std::max(p, q);
+			  const size_t end0 = std::min(count, (b0+1)*block), end1 = std::min(count, (b1+1)*block);
+			  for (size_t t0=b0*block; t0<end0; ++t0)
+				for (size_t t1=b1*block; t1<end1; ++t1)
+				  _pair_tile_range(f, container, t0, container, t1);
+			}
+		  }
+		});
+  }
+
+  template<typename F, class C>
+  inline void parallel_symmetric_for_each_pair(const F& f, C& container)
+  {
+	parallel_symmetric_for_each_pair_range(_pair_elements<F>(f), container);
+  }
+#endif
+
+}
+
+#endif
@@ -35,6 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "soa/table_traits.hpp"
 
+#include "aosoa/offset_table.hpp"
 #include "aosoa/table_iterator.hpp"
 
 #ifndef NOTBB
@@ -185,6 +186,38 @@ namespace aosoa {
 			f(0, lend-lbegin, lbegin, (rest.begin()+offset)...);
 		  });
 	  }
+#endif
+	};
+
+	template<class C, class... CN>
+	class _mixed_parallel_for_each_range {
+	public:
+#ifndef NOTBB
+	  template<typename F>
+	  static inline void loop(const F& f, C& first, CN&... rest) {
+#if defined(__ICC) || (GCC_VERSION >= 40900)
+		const size_t size = first.size();
+		const size_t chunk = _mixed_chunk(first, rest...);
+		tbb::parallel_for
+		  (tbb::blocked_range<size_t>(0, size/chunk+(size%chunk?1:0)),
+		   [&f, &first, &rest..., size, chunk](const tbb::blocked_range<size_t>& r) {
+			_mixed_range(f, r.begin()*chunk, std::min(r.end()*chunk, size), first, rest...);
+		  });
+#else
+		// capturing parameter packs is not supported in GCC 4.8.x.
+		_mixed_range(f, 0, first.size(), first, rest...);
+#endif
+	  }
+#endif
+
+#ifdef __cilk
+	  template<typename F>
+	  static inline void cilk_loop(const F& f, C& first, CN&... rest) {
+		const size_t size = first.size();
+		const size_t chunk = _mixed_chunk(first, rest...);
+		cilk_for (size_t i=0; i<size; i+=chunk)
+		  _mixed_range(f, i, std::min(i+chunk, size), first, rest...);
+	  }
 #endif
 	};
   }
@@ -196,7 +229,10 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_parallel_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>::
+	soa::sweep_hints(first, rest...);
+	std::conditional<soa::is_mixed_tabled<C, CN...>::value,
+					 _mixed_parallel_for_each_range<C, CN...>,
+					 _parallel_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>>::type::
 	  loop(f, first, rest...);
   }
 #endif
@@ -208,7 +244,10 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_parallel_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>::
+	soa::sweep_hints(first, rest...);
+	std::conditional<soa::is_mixed_tabled<C, CN...>::value,
+					 _mixed_parallel_for_each_range<C, CN...>,
+					 _parallel_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>>::type::
 	  cilk_loop(f, first, rest...);
   }
 #endif
@@ -339,6 +378,38 @@ namespace aosoa {
 		  f(0, std::min(grainsize, end-it), it, (others+offset)...);
 		}
 	  }
+#endif
+	};
+
+	template<typename T, typename... TN>
+	class _mixed_parallel_for_each_range_it {
+	public:
+#ifndef NOTBB
+	  template<typename F>
+	  static inline void loop(T begin, T end, const F& f, TN... others) {
+#if defined(__ICC) || (GCC_VERSION >= 40900)
+		const size_t size = end-begin;
+		const size_t chunk = _mixed_chunk_it(begin, others...);
+		tbb::parallel_for
+		  (tbb::blocked_range<size_t>(0, size/chunk+(size%chunk?1:0)),
+		   [&f, begin, others..., size, chunk](const tbb::blocked_range<size_t>& r) {
+			_mixed_range_it(f, r.begin()*chunk, std::min(r.end()*chunk, size), begin, others...);
+		  });
+#else
+		// capturing parameter packs is not supported in GCC 4.8.x.
+		_mixed_range_it(f, 0, end-begin, begin, others...);
+#endif
+	  }
+#endif
+
+#ifdef __cilk
+	  template<typename F>
+	  static inline void cilk_loop(T begin, T end, const F& f, TN... others) {
+		const size_t size = end-begin;
+		const size_t chunk = _mixed_chunk_it(begin, others...);
+		cilk_for (size_t i=0; i<size; i+=chunk)
+		  _mixed_range_it(f, i, std::min(i+chunk, size), begin, others...);
+	  }
 #endif
 	};
   }
@@ -350,7 +421,9 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_parallel_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>::
+	std::conditional<is_mixed_tabled_iterator<T, TN...>::value,
+					 _mixed_parallel_for_each_range_it<T, TN...>,
+					 _parallel_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>>::type::
 	  loop(begin, end, f, others...);
   }
 #endif
@@ -362,7 +435,9 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_parallel_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>::
+	std::conditional<is_mixed_tabled_iterator<T, TN...>::value,
+					 _mixed_parallel_for_each_range_it<T, TN...>,
+					 _parallel_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>>::type::
 	  loop(begin, end, f, others...);
   }
 #endif
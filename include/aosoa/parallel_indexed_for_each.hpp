@@ -36,6 +36,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "soa/table_traits.hpp"
 
 #include "aosoa/apply_tuple.hpp"
+#include "aosoa/loop_pragmas.hpp"
 #include "aosoa/table_iterator.hpp"
 
 #include "aosoa/parallel_indexed_for_each_range.hpp"
@@ -48,8 +49,8 @@ namespace aosoa {
   static inline void name(const F& f, C& first, CN&... rest) {			\
 	parallel_indexed_for_each_range										\
 	  ([&f](size_t start, size_t end, size_t offset,					\
-			typename soa::table_traits<C>::table_reference first,		\
-			typename soa::table_traits<CN>::table_reference... rest){	\
+			typename range_table_reference<C, C, CN...>::type first,	\
+			typename range_table_reference<CN, C, CN...>::type... rest){ \
 		__VA_ARGS__														\
 		  for (size_t i=start; i<end; ++i)								\
 			apply_tuple(f, std::forward_as_tuple(offset+i, first[i], rest[i]...)); \
@@ -63,8 +64,8 @@ namespace aosoa {
   static inline void name(const F& f, C& first, CN&... rest) {			\
 	cilk_parallel_indexed_for_each_range								\
 	  ([&f](size_t start, size_t end, size_t offset,					\
-			typename soa::table_traits<C>::table_reference first,		\
-			typename soa::table_traits<CN>::table_reference... rest){	\
+			typename range_table_reference<C, C, CN...>::type first,	\
+			typename range_table_reference<CN, C, CN...>::type... rest){ \
 		__VA_ARGS__														\
 		  for (size_t i=start; i<end; ++i)								\
 			apply_tuple(f, std::forward_as_tuple(offset+i, first[i], rest[i]...)); \
@@ -77,23 +78,19 @@ namespace aosoa {
 	public:
 #ifndef NOTBB
 	  def_parallel_indexed_for_each(loop);
-#ifdef __ICC
-	  def_parallel_indexed_for_each(vector_loop, _Pragma("vector always"));
-	  def_parallel_indexed_for_each(ivdep_loop, _Pragma("ivdep"));
-	  def_parallel_indexed_for_each(vector_ivdep_loop, _Pragma("ivdep") _Pragma("vector always"));
-	  def_parallel_indexed_for_each(simd_loop, _Pragma("simd"));
-	  def_parallel_indexed_for_each(novector_loop, _Pragma("novector"));
-#endif
+	  def_parallel_indexed_for_each(vector_loop, AOSOA_PRAGMA_VECTOR_ALWAYS);
+	  def_parallel_indexed_for_each(ivdep_loop, AOSOA_PRAGMA_IVDEP);
+	  def_parallel_indexed_for_each(vector_ivdep_loop, AOSOA_PRAGMA_VECTOR_IVDEP);
+	  def_parallel_indexed_for_each(simd_loop, AOSOA_PRAGMA_SIMD);
+	  def_parallel_indexed_for_each(novector_loop, AOSOA_PRAGMA_NOVECTOR);
 #endif
 #ifdef __cilk
 	  def_cilk_parallel_indexed_for_each(cilk_loop);
-#ifdef __ICC
-	  def_cilk_parallel_indexed_for_each(cilk_vector_loop, _Pragma("vector always"));
-	  def_cilk_parallel_indexed_for_each(cilk_ivdep_loop, _Pragma("ivdep"));
-	  def_cilk_parallel_indexed_for_each(cilk_vector_ivdep_loop, _Pragma("ivdep") _Pragma("vector always"));
-	  def_cilk_parallel_indexed_for_each(cilk_simd_loop, _Pragma("simd"));
-	  def_cilk_parallel_indexed_for_each(cilk_novector_loop, _Pragma("novector"));
-#endif
+	  def_cilk_parallel_indexed_for_each(cilk_vector_loop, AOSOA_PRAGMA_VECTOR_ALWAYS);
+	  def_cilk_parallel_indexed_for_each(cilk_ivdep_loop, AOSOA_PRAGMA_IVDEP);
+	  def_cilk_parallel_indexed_for_each(cilk_vector_ivdep_loop, AOSOA_PRAGMA_VECTOR_IVDEP);
+	  def_cilk_parallel_indexed_for_each(cilk_simd_loop, AOSOA_PRAGMA_SIMD);
+	  def_cilk_parallel_indexed_for_each(cilk_novector_loop, AOSOA_PRAGMA_NOVECTOR);
 #endif
 	};
   }
@@ -108,43 +105,51 @@ namespace aosoa {
 	_parallel_indexed_for_each<C>::loop(f, first, rest...);
   }
 
-#ifdef __ICC
   template<typename F, class C, class... CN>
   inline void parallel_vector_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each<C>::vector_loop(f, first, rest...);
   }
 
   template<typename F, class C, class... CN>
   inline void parallel_ivdep_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each<C>::ivdep_loop(f, first, rest...);
   }
 
   template<typename F, class C, class... CN>
   inline void parallel_vector_ivdep_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
-	_parallel_indexed_for_each<C>::vector_ivdep_loop(f, first, rest);
+#endif
+	_parallel_indexed_for_each<C>::vector_ivdep_loop(f, first, rest...);
   }
 
   template<typename F, class C, class... CN>
   inline void parallel_simd_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
-	_parallel_indexed_for_each<C>::simd_loop(f, first, rest);
+#endif
+	_parallel_indexed_for_each<C>::simd_loop(f, first, rest...);
   }
 
   template<typename F, class C, class... CN>
   inline void parallel_novector_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each<C>::novector_loop(f, first, rest...);
   }
 #endif
-#endif
 
 #ifdef __cilk
   template<typename F, class C, class... CN>
@@ -154,43 +159,51 @@ namespace aosoa {
 	_parallel_indexed_for_each<C>::cilk_loop(f, first, rest...);
   }
 
-#ifdef __ICC
   template<typename F, class C, class... CN>
   inline void cilk_parallel_vector_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each<C>::cilk_vector_loop(f, first, rest...);
   }
 
   template<typename F, class C, class... CN>
   inline void cilk_parallel_ivdep_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each<C>::cilk_ivdep_loop(f, first, rest...);
   }
 
   template<typename F, class C, class... CN>
   inline void cilk_parallel_vector_ivdep_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each<C>::cilk_vector_ivdep_loop(f, first, rest...);
   }
 
   template<typename F, class C, class... CN>
   inline void cilk_parallel_simd_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each<C>::cilk_simd_loop(f, first, rest...);
   }
 
   template<typename F, class C, class... CN>
   inline void cilk_parallel_novector_indexed_for_each(const F& f, C& first, CN&... rest)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each<C>::cilk_novector_loop(f, first, rest...);
   }
 #endif
-#endif
 
 
 #ifndef NOTBB
@@ -200,8 +213,8 @@ namespace aosoa {
 	parallel_indexed_for_each_range										\
 	  (begin, end,														\
 	   [&f](size_t start, size_t end, size_t offset,					\
-			typename table_iterator_traits<T>::table_reference first,	\
-			typename table_iterator_traits<TN>::table_reference... rest){ \
+			typename range_iterator_table_reference<T, T, TN...>::type first, \
+			typename range_iterator_table_reference<TN, T, TN...>::type... rest){ \
 		__VA_ARGS__														\
 		  for (size_t i=start; i<end; ++i)								\
 			apply_tuple(f, std::forward_as_tuple(offset+i, first[i], rest[i]...)); \
@@ -216,8 +229,8 @@ namespace aosoa {
 	cilk_parallel_indexed_for_each_range								\
 	  (begin, end,														\
 	   [&f](size_t start, size_t end, size_t offset,					\
-			typename table_iterator_traits<T>::table_reference first,	\
-			typename table_iterator_traits<TN>::table_reference... rest){ \
+			typename range_iterator_table_reference<T, T, TN...>::type first, \
+			typename range_iterator_table_reference<TN, T, TN...>::type... rest){ \
 		__VA_ARGS__														\
 		  for (size_t i=start; i<end; ++i)								\
 			apply_tuple(f, std::forward_as_tuple(offset+i, first[i], rest[i]...)); \
@@ -230,23 +243,19 @@ namespace aosoa {
 	public:
 #ifndef NOTBB
 	  def_parallel_indexed_for_each_it(loop);
-#ifdef __ICC
-	  def_parallel_indexed_for_each_it(vector_loop, _Pragma("vector always"));
-	  def_parallel_indexed_for_each_it(ivdep_loop, _Pragma("ivdep"));
-	  def_parallel_indexed_for_each_it(vector_ivdep_loop, _Pragma("ivdep") _Pragma("vector always"));
-	  def_parallel_indexed_for_each_it(simd_loop, _Pragma("simd"));
-	  def_parallel_indexed_for_each_it(novector_loop, _Pragma("novector"));
-#endif
+	  def_parallel_indexed_for_each_it(vector_loop, AOSOA_PRAGMA_VECTOR_ALWAYS);
+	  def_parallel_indexed_for_each_it(ivdep_loop, AOSOA_PRAGMA_IVDEP);
+	  def_parallel_indexed_for_each_it(vector_ivdep_loop, AOSOA_PRAGMA_VECTOR_IVDEP);
+	  def_parallel_indexed_for_each_it(simd_loop, AOSOA_PRAGMA_SIMD);
+	  def_parallel_indexed_for_each_it(novector_loop, AOSOA_PRAGMA_NOVECTOR);
 #endif
 #ifdef __cilk
 	  def_cilk_parallel_indexed_for_each_it(cilk_loop);
-#ifdef __ICC
-	  def_cilk_parallel_indexed_for_each_it(cilk_vector_loop, _Pragma("vector always"));
-	  def_cilk_parallel_indexed_for_each_it(cilk_ivdep_loop, _Pragma("ivdep"));
-	  def_cilk_parallel_indexed_for_each_it(cilk_vector_ivdep_loop, _Pragma("ivdep") _Pragma("vector always"));
-	  def_cilk_parallel_indexed_for_each_it(cilk_simd_loop, _Pragma("simd"));
-	  def_cilk_parallel_indexed_for_each_it(cilk_novector_loop, _Pragma("novector"));
-#endif
+	  def_cilk_parallel_indexed_for_each_it(cilk_vector_loop, AOSOA_PRAGMA_VECTOR_ALWAYS);
+	  def_cilk_parallel_indexed_for_each_it(cilk_ivdep_loop, AOSOA_PRAGMA_IVDEP);
+	  def_cilk_parallel_indexed_for_each_it(cilk_vector_ivdep_loop, AOSOA_PRAGMA_VECTOR_IVDEP);
+	  def_cilk_parallel_indexed_for_each_it(cilk_simd_loop, AOSOA_PRAGMA_SIMD);
+	  def_cilk_parallel_indexed_for_each_it(cilk_novector_loop, AOSOA_PRAGMA_NOVECTOR);
 #endif
 	};
   }
@@ -260,42 +269,50 @@ namespace aosoa {
 	_parallel_indexed_for_each_it<T>::loop(begin, end, f, others...);
   }
 
-#ifdef __ICC
   template<typename T, typename F, typename... TN>
   inline void parallel_vector_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::vector_loop(begin, end, f, others...);
   }
 
   template<typename T, typename F, typename... TN>
   inline void parallel_ivdep_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::ivdep_loop(begin, end, f, others...);
   }
 
   template<typename T, typename F, typename... TN>
   inline void parallel_vector_ivdep_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::vector_ivdep_loop(begin, end, f, others...);
   }
 
   template<typename T, typename F, typename... TN>
   inline void parallel_simd_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::simd_loop(begin, end, f, others...);
   }
 
   template<typename T, typename F, typename... TN>
   inline void parallel_novector_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::novector_loop(begin, end, f, others...);
   }
-#endif
 
 #ifdef __cilk
   template<typename T, typename F, typename... TN>
@@ -307,43 +324,51 @@ namespace aosoa {
 	_parallel_indexed_for_each_it<T>::cilk_loop(begin, end, f, others...);
   }
 
-#ifdef __ICC
   template<typename T, typename F, typename... TN>
   inline void cilk_parallel_vector_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::cilk_vector_loop(begin, end, f, others...);
   }
 
   template<typename T, typename F, typename... TN>
   inline void cilk_parallel_ivdep_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::cilk_ivdep_loop(begin, end, f, others...);
   }
 
   template<typename T, typename F, typename... TN>
   inline void cilk_parallel_vector_ivdep_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::cilk_vector_ivdep_loop(begin, end, f, others...);
   }
 
   template<typename T, typename F, typename... TN>
   inline void cilk_parallel_simd_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::cilk_simd_loop(begin, end, f, others...);
   }
 
   template<typename T, typename F, typename... TN>
   inline void cilk_parallel_novector_indexed_for_each(T begin, T end, const F& f, TN... others)
   {
+#ifdef __ICC
 #pragma forceinline recursive
+#endif
 	_parallel_indexed_for_each_it<T>::cilk_novector_loop(begin, end, f, others...);
   }
 #endif
-#endif
 
 }
 
@@ -35,6 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "soa/table_traits.hpp"
 
+#include "aosoa/offset_table.hpp"
 #include "aosoa/table_iterator.hpp"
 
 #ifndef NOTBB
@@ -186,6 +187,38 @@ namespace aosoa {
 			f(0, lend-lbegin, offset, lbegin, (rest.begin()+offset)...);
 		  });
 	  }
+#endif
+	};
+
+	template<class C, class... CN>
+	class _mixed_parallel_indexed_for_each_range {
+	public:
+#ifndef NOTBB
+	  template<typename F>
+	  static inline void loop(const F& f, C& first, CN&... rest) {
+#if defined(__ICC) || (GCC_VERSION >= 40900)
+		const size_t size = first.size();
+		const size_t chunk = _mixed_chunk(first, rest...);
+		tbb::parallel_for
+		  (tbb::blocked_range<size_t>(0, size/chunk+(size%chunk?1:0)),
+		   [&f, &first, &rest..., size, chunk](const tbb::blocked_range<size_t>& r) {
+			_indexed_mixed_range(f, r.begin()*chunk, std::min(r.end()*chunk, size), first, rest...);
+		  });
+#else
+		// capturing parameter packs is not supported in GCC 4.8.x.
+		_indexed_mixed_range(f, 0, first.size(), first, rest...);
+#endif
+	  }
+#endif
+
+#ifdef __cilk
+	  template<typename F>
+	  static inline void cilk_loop(const F& f, C& first, CN&... rest) {
+		const size_t size = first.size();
+		const size_t chunk = _mixed_chunk(first, rest...);
+		cilk_for (size_t i=0; i<size; i+=chunk)
+		  _indexed_mixed_range(f, i, std::min(i+chunk, size), first, rest...);
+	  }
 #endif
 	};
   }
@@ -197,7 +230,10 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_parallel_indexed_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>::
+	soa::sweep_hints(first, rest...);
+	std::conditional<soa::is_mixed_tabled<C, CN...>::value,
+					 _mixed_parallel_indexed_for_each_range<C, CN...>,
+					 _parallel_indexed_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>>::type::
 	  loop(f, first, rest...);
   }
 #endif
@@ -209,7 +245,10 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_parallel_indexed_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>::
+	soa::sweep_hints(first, rest...);
+	std::conditional<soa::is_mixed_tabled<C, CN...>::value,
+					 _mixed_parallel_indexed_for_each_range<C, CN...>,
+					 _parallel_indexed_for_each_range<soa::is_compatibly_tabled<C, CN...>::value, C, CN...>>::type::
 	  cilk_loop(f, first, rest...);
   }
 #endif
@@ -357,6 +396,38 @@ namespace aosoa {
 			f(0, lend-lbegin, offset, lbegin, (others+offset)...);
 		  });
 	  }
+#endif
+	};
+
+	template<typename T, typename... TN>
+	class _mixed_parallel_indexed_for_each_range_it {
+	public:
+#ifndef NOTBB
+	  template<typename F>
+	  static inline void loop(T begin, T end, const F& f, TN... others) {
+#if defined(__ICC) || (GCC_VERSION >= 40900)
+		const size_t size = end-begin;
+		const size_t chunk = _mixed_chunk_it(begin, others...);
+		tbb::parallel_for
+		  (tbb::blocked_range<size_t>(0, size/chunk+(size%chunk?1:0)),
+		   [&f, begin, others..., size, chunk](const tbb::blocked_range<size_t>& r) {
+			_indexed_mixed_range_it(f, r.begin()*chunk, std::min(r.end()*chunk, size), begin, others...);
+		  });
+#else
+		// capturing parameter packs is not supported in GCC 4.8.x.
+		_indexed_mixed_range_it(f, 0, end-begin, begin, others...);
+#endif
+	  }
+#endif
+
+#ifdef __cilk
+	  template<typename F>
+	  static inline void cilk_loop(T begin, T end, const F& f, TN... others) {
+		const size_t size = end-begin;
+		const size_t chunk = _mixed_chunk_it(begin, others...);
+		cilk_for (size_t i=0; i<size; i+=chunk)
+		  _indexed_mixed_range_it(f, i, std::min(i+chunk, size), begin, others...);
+	  }
 #endif
 	};
   }
@@ -368,7 +439,9 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_parallel_indexed_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>::
+	std::conditional<is_mixed_tabled_iterator<T, TN...>::value,
+					 _mixed_parallel_indexed_for_each_range_it<T, TN...>,
+					 _parallel_indexed_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>>::type::
 	  loop(begin, end, f, others...);
   }
 #endif
@@ -380,7 +453,9 @@ namespace aosoa {
 #ifdef __ICC
 #pragma forceinline recursive
 #endif
-	_parallel_indexed_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>::
+	std::conditional<is_mixed_tabled_iterator<T, TN...>::value,
+					 _mixed_parallel_indexed_for_each_range_it<T, TN...>,
+					 _parallel_indexed_for_each_range_it<is_compatibly_tabled_iterator<T, TN...>::value, T, TN...>>::type::
 	  cilk_loop(begin, end, f, others...);
   }
 #endif
@@ -0,0 +1,122 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_PARALLEL_REDUCE
+#define AOSOA_PARALLEL_REDUCE
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "soa/table_traits.hpp"
+
+#include "aosoa/offset_table.hpp"
+#include "aosoa/reduce.hpp"
+
+#ifndef NOTBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_reduce.h"
+#endif
+
+namespace aosoa {
+
+#ifndef NOTBB
+  // parallel versions of reduce and transform_reduce. every task
+  // reduces a chunk of elements as in the sequential versions, and
+  // the partial results are combined as a tree by tbb::parallel_reduce.
+  // op must be associative and commutative.
+
+  template<size_t L = 8, typename F, typename T, typename Op, class C, class... CN>
+  inline T parallel_reduce(const F& f, const T& identity, const Op& op, C& first, CN&... rest)
+  {
+	soa::sweep_hints(first, rest...);
+#if defined(__ICC) || (GCC_VERSION >= 40900)
+	const size_t size = first.size();
+	const size_t chunk = _reduce_chunk(_reduce_grainsize, first, rest...);
+	return tbb::parallel_reduce
+	  (tbb::blocked_range<size_t>(0, size/chunk+(size%chunk?1:0)), identity,
+	   [&f, &identity, &op, &first, &rest..., size, chunk](const tbb::blocked_range<size_t>& r, T accumulator) {
+		return op(accumulator, _reduce_range<L>(f, identity, op, r.begin()*chunk,
+												std::min(r.end()*chunk, size), first, rest...));
+	  }, op);
+#else
+	// capturing parameter packs is not supported in GCC 4.8.x.
+	return _reduce_range<L>(f, identity, op, 0, first.size(), first, rest...);
+#endif
+  }
+
+  template<size_t L = 8, typename F, typename T, typename Op, class C, class... CN>
+  inline T parallel_transform_reduce(const F& transform, const T& identity, const Op& op, C& first, CN&... rest)
+  {
+	return parallel_reduce<L>(_transform_accumulate<F,Op>(transform, op), identity, op, first, rest...);
+  }
+
+  // parallel versions of deterministic_reduce and
+  // deterministic_transform_reduce. the chunks are reduced in
+  // parallel, but with the same partition and the same combination
+  // tree as in the sequential versions, so that the result does not
+  // depend on the number of threads or on work stealing. op must be
+  // associative and commutative.
+
+  template<size_t L = 8, typename F, typename T, typename Op, class C, class... CN>
+  inline T parallel_deterministic_reduce(const F& f, const T& identity, const Op& op, C& first, CN&... rest)
+  {
+	soa::sweep_hints(first, rest...);
+	const size_t size = first.size();
+	const size_t chunk = _reduce_chunk(_reduce_grainsize, first, rest...);
+	const size_t chunks = size/chunk+(size%chunk?1:0);
+	if (chunks == 0) return identity;
+	std::vector<T> partials(chunks, identity);
+#if defined(__ICC) || (GCC_VERSION >= 40900)
+	T* const result = partials.data();
+	tbb::parallel_for
+	  (tbb::blocked_range<size_t>(0, chunks),
+	   [&f, &identity, &op, &first, &rest..., result, size, chunk](const tbb::blocked_range<size_t>& r) {
+		for (size_t i=r.begin(); i<r.end(); ++i)
+		  result[i] = _reduce_range<L>(f, identity, op, i*chunk, std::min((i+1)*chunk, size), first, rest...);
+	  });
+#else
+	// capturing parameter packs is not supported in GCC 4.8.x.
+	for (size_t i=0; i<chunks; ++i)
+	  partials[i] = _reduce_range<L>(f, identity, op, i*chunk, std::min((i+1)*chunk, size), first, rest...);
+#endif
+	return _reduce_tree(partials.data(), 0, chunks, op);
+  }
+
+  template<size_t L = 8, typename F, typename T, typename Op, class C, class... CN>
+  inline T parallel_deterministic_transform_reduce(const F& transform, const T& identity, const Op& op, C& first, CN&... rest)
+  {
+	return parallel_deterministic_reduce<L>(_transform_accumulate<F,Op>(transform, op), identity, op, first, rest...);
+  }
+#endif
+
+}
+
+#endif
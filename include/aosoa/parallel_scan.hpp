@@ -0,0 +1,152 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_PARALLEL_SCAN
+#define AOSOA_PARALLEL_SCAN
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "soa/table_traits.hpp"
+
+#include "aosoa/offset_table.hpp"
+#include "aosoa/reduce.hpp"
+#include "aosoa/scan.hpp"
+
+#ifndef NOTBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace aosoa {
+
+#ifndef NOTBB
+  namespace {
+	template<typename T, typename Values, class C>
+	inline T _scan_value (const Values& values, size_t index, C& source) {
+	  T buffer;
+	  auto&& table = _mixed_container<C>::table(source, index);
+	  return *values.get(table, 0, 1, &buffer);
+	}
+
+	// scans [begin, end) in two passes over fixed chunks. the first
+	// pass folds all chunks but the last in parallel, the carries of
+	// the chunks are then scanned sequentially, and the second pass
+	// scans all chunks in parallel, each starting from its carry.
+
+	template<bool exclusive, size_t O, typename T, typename Op, typename Values, class C0, class C1>
+	inline T _parallel_scan_range (const Values& values, const Op& op, T carry,
+								   size_t begin, size_t end, C0& source, C1& destination) {
+	  if (begin >= end) return carry;
+	  const size_t chunk = _reduce_chunk(_reduce_grainsize, source, destination);
+	  const size_t first = begin/chunk;
+	  const size_t chunks = (end+chunk-1)/chunk - first;
+	  std::vector<T> carries(chunks, carry);
+	  T* const result = carries.data();
+	  // the first value of a chunk starts its fold, so that no identity is needed.
+	  tbb::parallel_for
+		(tbb::blocked_range<size_t>(1, chunks),
+		 [&values, &op, &source, &destination, result, begin, chunk, first](const tbb::blocked_range<size_t>& r) {
+		  for (size_t i=r.begin(); i<r.end(); ++i) {
+			const size_t start = std::max(begin, (first+i-1)*chunk);
+			result[i] = _fold_range(values, op, _scan_value<T>(values, start, source),
+									start+1, (first+i)*chunk, source, destination);
+		  }
+		});
+	  for (size_t i=1; i<chunks; ++i) result[i] = op(result[i-1], result[i]);
+	  T total = carry;
+	  tbb::parallel_for
+		(tbb::blocked_range<size_t>(0, chunks),
+		 [&values, &op, &source, &destination, &total, result, begin, end, chunk, first, chunks](const tbb::blocked_range<size_t>& r) {
+		  for (size_t i=r.begin(); i<r.end(); ++i) {
+			const T last = _scan_range<exclusive, O>(values, op, result[i],
+													 std::max(begin, (first+i)*chunk),
+													 std::min(end, (first+i+1)*chunk),
+													 source, destination);
+			if (i == chunks-1) total = last;
+		  }
+		});
+	  return total;
+	}
+  }
+
+  // parallel versions of the prefix scans. op must be associative,
+  // and is applied in a different order than in the sequential
+  // versions.
+
+  template<size_t I, size_t O, typename Op, class C0, class C1>
+  inline typename _column_type<C0,I>::type
+  parallel_inclusive_scan(C0& source, C1& destination, const Op& op)
+  {
+	typedef typename _column_type<C0,I>::type T;
+	static_assert(std::is_same<T, typename _column_type<C1,O>::type>::value,
+				  "the scanned columns must have the same type");
+	if (source.size() == 0) return T();
+	const T value = *std::get<I>(_mixed_container<C0>::table(source, 0).columns());
+	*std::get<O>(_mixed_container<C1>::table(destination, 0).columns()) = value;
+	return _parallel_scan_range<false, O>(_column_values<I>(), op, value, 1, source.size(), source, destination);
+  }
+
+  template<size_t I, size_t O, class C0, class C1>
+  inline typename _column_type<C0,I>::type
+  parallel_inclusive_scan(C0& source, C1& destination)
+  {
+	return parallel_inclusive_scan<I,O>(source, destination, std::plus<typename _column_type<C0,I>::type>());
+  }
+
+  template<size_t I, size_t O, typename T, typename Op, class C0, class C1>
+  inline T parallel_exclusive_scan(C0& source, C1& destination, const T& init, const Op& op)
+  {
+	return _parallel_scan_range<true, O>(_column_values<I>(), op, init, 0, source.size(), source, destination);
+  }
+
+  template<size_t I, size_t O, typename T, class C0, class C1>
+  inline T parallel_exclusive_scan(C0& source, C1& destination, const T& init)
+  {
+	return parallel_exclusive_scan<I,O>(source, destination, init, std::plus<T>());
+  }
+
+  template<size_t O, typename Op, typename F, typename T, class C0, class C1>
+  inline T parallel_transform_inclusive_scan(C0& source, C1& destination, const Op& op, const F& transform, const T& init)
+  {
+	return _parallel_scan_range<false, O>(_transform_values<F>(transform), op, init, 0, source.size(), source, destination);
+  }
+
+  template<size_t O, typename T, typename Op, typename F, class C0, class C1>
+  inline T parallel_transform_exclusive_scan(C0& source, C1& destination, const T& init, const Op& op, const F& transform)
+  {
+	return _parallel_scan_range<true, O>(_transform_values<F>(transform), op, init, 0, source.size(), source, destination);
+  }
+#endif
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_PARALLEL_SORT
+#define AOSOA_PARALLEL_SORT
+
+#include <cstddef>
+
+#include <algorithm>
+
+#include "aosoa/sort.hpp"
+
+#ifndef NOTBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace aosoa {
+
+#ifndef NOTBB
+  namespace {
+	// the radix passes need a histogram per chunk, so the number of
+	// chunks is limited.
+
+	constexpr size_t _sort_grainsize = 16384;
+	constexpr size_t _sort_chunks = 256;
+
+	class _parallel_chunks {
+	public:
+	  inline size_t count (size_t n) const {
+		return std::max(size_t(1), std::min(n/_sort_grainsize, _sort_chunks));
+	  }
+
+	  template<typename F>
+	  inline void operator() (size_t chunks, const F& f) const {
+		tbb::parallel_for
+		  (tbb::blocked_range<size_t>(0, chunks),
+		   [&f](const tbb::blocked_range<size_t>& r) {
+			for (size_t i=r.begin(); i<r.end(); ++i) f(i);
+		  }, tbb::simple_partitioner());
+	  }
+	};
+  }
+
+  // parallel versions of sort_by_key and stable_sort_by_key. the key
+  // loads, the histograms and scatters of the radix passes, and the
+  // column permutations run in parallel over the same chunks.
+  // keys that are not arithmetic are sorted sequentially.
+
+  template<size_t I, class C>
+  inline void parallel_sort_by_key(C& container)
+  {
+	_sort_by_key<I, false>(container, _parallel_chunks());
+  }
+
+  template<size_t I, class C>
+  inline void parallel_stable_sort_by_key(C& container)
+  {
+	_sort_by_key<I, true>(container, _parallel_chunks());
+  }
+#endif
+
+}
+
+#endif
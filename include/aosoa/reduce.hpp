@@ -0,0 +1,196 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_REDUCE
+#define AOSOA_REDUCE
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include "soa/table_traits.hpp"
+
+#include "aosoa/apply_tuple.hpp"
+#include "aosoa/offset_table.hpp"
+
+namespace aosoa {
+
+  namespace {
+	// accumulates the elements of a run into L lanes: element i of a
+	// block of L elements goes into lane i, so that the lanes can be
+	// updated independently. the lanes are kept across runs.
+
+	template<size_t L, typename F, typename T>
+	class _reduce_run {
+	private:
+	  const F& f;
+	  std::array<T,L>& lanes;
+
+	public:
+	  _reduce_run (const F& f, std::array<T,L>& lanes) : f(f), lanes(lanes) {}
+
+	  template<typename... TN>
+	  inline void operator() (size_t start, size_t end, TN... tables) const {
+		size_t i = start;
+		for (; i+L<=end; i+=L)
+		  for (size_t l=0; l<L; ++l)
+			apply_tuple(f, std::forward_as_tuple(lanes[l], tables[i+l]...));
+		for (size_t l=0; i<end; ++i, ++l)
+		  apply_tuple(f, std::forward_as_tuple(lanes[l], tables[i]...));
+	  }
+	};
+
+	// combine the lanes pairwise, as a tree.
+
+	template<size_t L, typename T, typename Op>
+	inline T _reduce_lanes (std::array<T,L>& lanes, const Op& op) {
+	  for (size_t width=L/2; width>0; width/=2)
+		for (size_t l=0; l<width; ++l)
+		  lanes[l] = op(lanes[l], lanes[l+width]);
+	  return lanes[0];
+	}
+
+	// reduce the elements [begin, end) of the containers, in runs that
+	// do not cross a table boundary in any of them.
+
+	template<size_t L, typename F, typename T, typename Op, class... CN>
+	inline T _reduce_range (const F& f, const T& identity, const Op& op,
+							size_t begin, size_t end, CN&... containers) {
+	  static_assert(L > 0 && (L & (L-1)) == 0, "the number of lanes must be a power of two");
+	  std::array<T,L> lanes;
+	  lanes.fill(identity);
+	  _mixed_range(_reduce_run<L,F,T>(f, lanes), begin, end, containers...);
+	  return _reduce_lanes(lanes, op);
+	}
+
+	// the deterministic reductions split the elements into chunks of at
+	// least grainsize elements, which are multiples of the table sizes
+	// when possible, so that the runs inside a chunk stay aligned with
+	// the tables. the chunks only depend on the size and the table
+	// sizes of the containers, not on the number of threads.
+
+	constexpr size_t _reduce_grainsize = 1024;
+
+	template<class... CN>
+	inline size_t _reduce_chunk (size_t grainsize, CN&... containers) {
+	  const size_t chunk = _mixed_chunk(containers...);
+	  return chunk >= grainsize ? chunk : (grainsize+chunk-1)/chunk*chunk;
+	}
+
+	// combine the partial results of the chunks [begin, end) pairwise,
+	// as a tree of a fixed shape.
+
+	template<typename T, typename Op>
+	inline T _reduce_tree (const T* partials, size_t begin, size_t end, const Op& op) {
+	  if (end-begin == 1) return partials[begin];
+	  const size_t middle = begin + (end-begin)/2;
+	  return op(_reduce_tree(partials, begin, middle, op), _reduce_tree(partials, middle, end, op));
+	}
+
+	// turns a transform into an accumulating function for _reduce_run.
+
+	template<typename F, typename Op>
+	class _transform_accumulate {
+	private:
+	  const F& transform;
+	  const Op& op;
+
+	public:
+	  _transform_accumulate (const F& transform, const Op& op) : transform(transform), op(op) {}
+
+	  template<typename T, typename... VN>
+	  inline void operator() (T& accumulator, VN&... values) const {
+		accumulator = op(accumulator, transform(values...));
+	  }
+	};
+  }
+
+  // reduce the elements of the containers into a value of type T. f
+  // is called as f(accumulator, elements...), and adds the elements
+  // to the accumulator in place. T can hold several reduction
+  // variables at once, for example a struct with a sum of x and a sum
+  // of y. op combines two accumulators, and identity is its identity
+  // element.
+  //
+  // the elements are spread over L independent accumulators, so that
+  // the inner loop can be vectorized. these are combined with op at
+  // the end. the elements therefore do not reach the accumulators in
+  // order, and as for std::reduce, op must be associative and
+  // commutative, and f must accumulate consistently with op.
+
+  template<size_t L = 8, typename F, typename T, typename Op, class C, class... CN>
+  inline T reduce(const F& f, const T& identity, const Op& op, C& first, CN&... rest)
+  {
+	soa::sweep_hints(first, rest...);
+	return _reduce_range<L>(f, identity, op, 0, first.size(), first, rest...);
+  }
+
+  // reduce the results of transform(elements...) with op, which must
+  // be associative and commutative.
+
+  template<size_t L = 8, typename F, typename T, typename Op, class C, class... CN>
+  inline T transform_reduce(const F& transform, const T& identity, const Op& op, C& first, CN&... rest)
+  {
+	return reduce<L>(_transform_accumulate<F,Op>(transform, op), identity, op, first, rest...);
+  }
+
+  // deterministic versions of reduce and transform_reduce. the
+  // elements are reduced in fixed chunks, and the partial results
+  // are combined as a balanced tree. for floating-point sums, this
+  // is a form of pairwise summation, and the result is bitwise
+  // identical to that of parallel_deterministic_reduce, on any
+  // number of threads. the chunks use the same lanes as reduce, so op
+  // must still be associative and commutative.
+
+  template<size_t L = 8, typename F, typename T, typename Op, class C, class... CN>
+  inline T deterministic_reduce(const F& f, const T& identity, const Op& op, C& first, CN&... rest)
+  {
+	soa::sweep_hints(first, rest...);
+	const size_t size = first.size();
+	const size_t chunk = _reduce_chunk(_reduce_grainsize, first, rest...);
+	const size_t chunks = size/chunk+(size%chunk?1:0);
+	if (chunks == 0) return identity;
+	std::vector<T> partials;
+	partials.reserve(chunks);
+	for (size_t i=0; i<chunks; ++i)
+	  partials.push_back(_reduce_range<L>(f, identity, op, i*chunk, std::min((i+1)*chunk, size), first, rest...));
+	return _reduce_tree(partials.data(), 0, chunks, op);
+  }
+
+  template<size_t L = 8, typename F, typename T, typename Op, class C, class... CN>
+  inline T deterministic_transform_reduce(const F& transform, const T& identity, const Op& op, C& first, CN&... rest)
+  {
+	return deterministic_reduce<L>(_transform_accumulate<F,Op>(transform, op), identity, op, first, rest...);
+  }
+
+}
+
+#endif
@@ -0,0 +1,248 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_SCAN
+#define AOSOA_SCAN
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+
+#include "soa/simd.hpp"
+#include "soa/table_traits.hpp"
+
+#include "aosoa/offset_table.hpp"
+
+namespace aosoa {
+
+  namespace {
+	// scan count values from in to out, starting from carry, and
+	// return the new carry. in and out may be the same column.
+
+	template<bool exclusive, typename S, typename T, typename Op>
+	inline T _scan_values (const S* in, T* out, size_t count, T carry, const Op& op) {
+	  for (size_t i=0; i<count; ++i) {
+		if (exclusive) {
+		  const T value = in[i];
+		  out[i] = carry;
+		  carry = op(carry, value);
+		} else {
+		  carry = op(carry, in[i]);
+		  out[i] = carry;
+		}
+	  }
+	  return carry;
+	}
+
+	// sums of arithmetic values are scanned in simd registers, W
+	// values at a time, with a carry that is added to each of them.
+
+	template<bool exclusive, typename T>
+	inline typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T,bool>::value && (sizeof(T) <= 8), T>::type
+	_scan_values (const T* in, T* out, size_t count, T carry, const std::plus<T>& op) {
+	  constexpr size_t W = 32/sizeof(T);
+	  typedef soa::simd<T,W> V;
+	  size_t i = 0;
+	  for (; i+W<=count; i+=W) {
+		const V value = V::load(in+i);
+		if (exclusive) {
+		  const V result = soa::prefix_sum(soa::shift_up<1>(value)) + V(carry);
+		  result.store(out+i);
+		  carry = result[W-1] + value[W-1];
+		} else {
+		  const V result = soa::prefix_sum(value) + V(carry);
+		  result.store(out+i);
+		  carry = result[W-1];
+		}
+	  }
+	  return _scan_values<exclusive, T, T, std::plus<T>>(in+i, out+i, count-i, carry, op);
+	}
+
+	template<typename S, typename T, typename Op>
+	inline T _fold_values (const S* in, size_t count, T carry, const Op& op) {
+	  for (size_t i=0; i<count; ++i) carry = op(carry, in[i]);
+	  return carry;
+	}
+
+	// the values to scan: column I of the source tables, or the
+	// results of a transform of the source elements, computed into a
+	// buffer in blocks.
+
+	constexpr size_t _scan_block = 256;
+
+	template<size_t I>
+	class _column_values {
+	public:
+	  template<typename Table, typename T>
+	  inline auto get (Table& table, size_t start, size_t, T*) const
+		-> decltype(std::get<I>(table.columns())+start)
+	  {return std::get<I>(table.columns())+start;}
+	};
+
+	template<typename F>
+	class _transform_values {
+	private:
+	  const F& transform;
+
+	public:
+	  _transform_values (const F& transform) : transform(transform) {}
+
+	  template<typename Table, typename T>
+	  inline const T* get (Table& table, size_t start, size_t count, T* buffer) const {
+		for (size_t i=0; i<count; ++i) {
+		  auto&& element = table[start+i];
+		  buffer[i] = transform(element);
+		}
+		return buffer;
+	  }
+	};
+
+	// range functors for _mixed_range: scan into column O of the
+	// destination tables, or only fold the values to compute the
+	// carry of a chunk.
+
+	template<bool exclusive, size_t O, typename T, typename Op, typename Values>
+	class _scan_run {
+	private:
+	  const Values& values;
+	  const Op& op;
+	  T& carry;
+
+	public:
+	  _scan_run (const Values& values, const Op& op, T& carry) : values(values), op(op), carry(carry) {}
+
+	  template<typename S, typename D>
+	  inline void operator() (size_t start, size_t end, S source, D destination) const {
+		std::array<T,_scan_block> buffer;
+		T* const out = std::get<O>(destination.columns());
+		for (size_t i=start; i<end; i+=_scan_block) {
+		  const size_t count = std::min(end-i, _scan_block);
+		  carry = _scan_values<exclusive>(values.get(source, i, count, buffer.data()), out+i, count, carry, op);
+		}
+	  }
+	};
+
+	template<typename T, typename Op, typename Values>
+	class _fold_run {
+	private:
+	  const Values& values;
+	  const Op& op;
+	  T& carry;
+
+	public:
+	  _fold_run (const Values& values, const Op& op, T& carry) : values(values), op(op), carry(carry) {}
+
+	  template<typename S, typename D>
+	  inline void operator() (size_t start, size_t end, S source, D) const {
+		std::array<T,_scan_block> buffer;
+		for (size_t i=start; i<end; i+=_scan_block) {
+		  const size_t count = std::min(end-i, _scan_block);
+		  carry = _fold_values(values.get(source, i, count, buffer.data()), count, carry, op);
+		}
+	  }
+	};
+
+	template<bool exclusive, size_t O, typename T, typename Op, typename Values, class C0, class C1>
+	inline T _scan_range (const Values& values, const Op& op, T carry,
+						  size_t begin, size_t end, C0& source, C1& destination) {
+	  _mixed_range(_scan_run<exclusive, O, T, Op, Values>(values, op, carry), begin, end, source, destination);
+	  return carry;
+	}
+
+	template<typename T, typename Op, typename Values, class C0, class C1>
+	inline T _fold_range (const Values& values, const Op& op, T carry,
+						  size_t begin, size_t end, C0& source, C1& destination) {
+	  _mixed_range(_fold_run<T, Op, Values>(values, op, carry), begin, end, source, destination);
+	  return carry;
+	}
+  }
+
+  // prefix scans of leaf column I of source into leaf column O of
+  // destination, which must have at least the same size. source and
+  // destination may be the same container, and I and O the same
+  // column. the containers must be tabled, but may have different
+  // table sizes. the scans return the reduction of all values, for
+  // example the total count when turning counts into offsets.
+  //
+  // sums of arithmetic types are scanned in simd registers.
+
+  template<size_t I, size_t O, typename Op, class C0, class C1>
+  inline typename _column_type<C0,I>::type
+  inclusive_scan(C0& source, C1& destination, const Op& op)
+  {
+	typedef typename _column_type<C0,I>::type T;
+	static_assert(std::is_same<T, typename _column_type<C1,O>::type>::value,
+				  "the scanned columns must have the same type");
+	if (source.size() == 0) return T();
+	// the first value is the initial carry, so that no identity is needed.
+	const T value = *std::get<I>(_mixed_container<C0>::table(source, 0).columns());
+	*std::get<O>(_mixed_container<C1>::table(destination, 0).columns()) = value;
+	return _scan_range<false, O>(_column_values<I>(), op, value, 1, source.size(), source, destination);
+  }
+
+  template<size_t I, size_t O, class C0, class C1>
+  inline typename _column_type<C0,I>::type
+  inclusive_scan(C0& source, C1& destination)
+  {
+	return inclusive_scan<I,O>(source, destination, std::plus<typename _column_type<C0,I>::type>());
+  }
+
+  template<size_t I, size_t O, typename T, typename Op, class C0, class C1>
+  inline T exclusive_scan(C0& source, C1& destination, const T& init, const Op& op)
+  {
+	return _scan_range<true, O>(_column_values<I>(), op, init, 0, source.size(), source, destination);
+  }
+
+  template<size_t I, size_t O, typename T, class C0, class C1>
+  inline T exclusive_scan(C0& source, C1& destination, const T& init)
+  {
+	return exclusive_scan<I,O>(source, destination, init, std::plus<T>());
+  }
+
+  // the same, but scanning transform(element) for the elements of
+  // source, which need not be tabled, starting from init.
+
+  template<size_t O, typename Op, typename F, typename T, class C0, class C1>
+  inline T transform_inclusive_scan(C0& source, C1& destination, const Op& op, const F& transform, const T& init)
+  {
+	return _scan_range<false, O>(_transform_values<F>(transform), op, init, 0, source.size(), source, destination);
+  }
+
+  template<size_t O, typename T, typename Op, typename F, class C0, class C1>
+  inline T transform_exclusive_scan(C0& source, C1& destination, const T& init, const Op& op, const F& transform)
+  {
+	return _scan_range<true, O>(_transform_values<F>(transform), op, init, 0, source.size(), source, destination);
+  }
+
+}
+
+#endif
@@ -0,0 +1,302 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_SORT
+#define AOSOA_SORT
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "soa/table_traits.hpp"
+
+#include "aosoa/offset_table.hpp"
+
+namespace aosoa {
+
+  namespace {
+	// arithmetic keys are mapped to unsigned integers with the same
+	// order, which are sorted with a least significant digit radix
+	// sort. other keys are sorted by comparison.
+
+	template<typename T, typename Enable = void>
+	class _radix_key {
+	public:
+	  static constexpr bool radix = false;
+	};
+
+	template<typename T>
+	class _radix_key<T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type> {
+	public:
+	  static constexpr bool radix = true;
+	  typedef T type;
+	  static inline type get (T key) {return key;}
+	};
+
+	template<typename T>
+	class _radix_key<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type> {
+	public:
+	  static constexpr bool radix = true;
+	  typedef typename std::make_unsigned<T>::type type;
+	  static inline type get (T key) {return type(type(key) ^ type(type(1) << (8*sizeof(T)-1)));}
+	};
+
+	template<typename T>
+	class _radix_key<T, typename std::enable_if<std::is_floating_point<T>::value &&
+												(sizeof(T) == 4 || sizeof(T) == 8)>::type> {
+	public:
+	  static constexpr bool radix = true;
+	  typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type type;
+	  static inline type get (T key) {
+		const type sign = type(1) << (8*sizeof(T)-1);
+		type bits;
+		std::memcpy(&bits, &key, sizeof(T));
+		return bits & sign ? ~bits : bits | sign;
+	  }
+	};
+
+	constexpr size_t _radix_bits = 8;
+	constexpr size_t _radix_buckets = size_t(1) << _radix_bits;
+
+	// runs f(i) for all chunks i, one after the other. the parallel
+	// versions pass an object that runs the chunks in parallel.
+
+	class _sequential_chunks {
+	public:
+	  inline size_t count (size_t) const {return 1;}
+
+	  template<typename F>
+	  inline void operator() (size_t chunks, const F& f) const {
+		for (size_t i=0; i<chunks; ++i) f(i);
+	  }
+	};
+
+	// the column pointers of leaf column N in all tables of container C.
+
+	template<size_t N, class C>
+	inline std::vector<typename _column_type<C,N>::type*> _table_columns (C& container) {
+	  const size_t size = soa::table_traits<C>::table_size;
+	  const size_t n = container.size();
+	  std::vector<typename _column_type<C,N>::type*> result(n/size+(n%size?1:0));
+	  for (size_t i=0; i<result.size(); ++i) result[i] = std::get<N>(container.data()[i].columns());
+	  return result;
+	}
+
+	// compute the permutation that sorts the keys.
+
+	template<typename T, bool radix = _radix_key<T>::radix> class _key_sort;
+
+	template<typename T>
+	class _key_sort<T, true> {
+	public:
+	  template<bool stable, size_t size, class Chunks>
+	  static inline void sort (T* const* columns, size_t n, std::vector<size_t>& permutation, const Chunks& chunks) {
+		typedef typename _radix_key<T>::type U;
+		const size_t count = chunks.count(n);
+		const size_t chunk = (n+count-1)/count;
+		std::vector<U> keys(n), next_keys(n);
+		std::vector<size_t> next_permutation(n);
+		std::vector<size_t> histograms(count*_radix_buckets);
+		U* key = keys.data();
+		U* next_key = next_keys.data();
+		size_t* index = permutation.data();
+		size_t* next_index = next_permutation.data();
+		size_t* const histogram = histograms.data();
+
+		chunks(count, [columns, key, index, n, chunk](size_t i) {
+			const size_t end = std::min((i+1)*chunk, n);
+			for (size_t j=i*chunk; j<end; ++j) {
+			  key[j] = _radix_key<T>::get(columns[j/size][j%size]);
+			  index[j] = j;
+			}
+		  });
+
+		for (size_t shift=0; shift<8*sizeof(U); shift+=_radix_bits) {
+		  chunks(count, [key, histogram, shift, n, chunk](size_t i) {
+			  size_t* const buckets = histogram+i*_radix_buckets;
+			  std::fill(buckets, buckets+_radix_buckets, 0);
+			  const size_t end = std::min((i+1)*chunk, n);
+			  for (size_t j=i*chunk; j<end; ++j) ++buckets[(key[j] >> shift) & (_radix_buckets-1)];
+			});
+
+		  // the offsets of the buckets of each chunk, bucket by bucket,
+		  // so that the order of equal digits is kept. a digit that is
+		  // the same for all keys does not need a pass.
+		  size_t offset = 0;
+		  bool skip = false;
+		  for (size_t b=0; b<_radix_buckets; ++b) {
+			const size_t start = offset;
+			for (size_t i=0; i<count; ++i) {
+			  const size_t c = histogram[i*_radix_buckets+b];
+			  histogram[i*_radix_buckets+b] = offset;
+			  offset += c;
+			}
+			skip = skip || offset-start == n;
+		  }
+		  if (skip) continue;
+
+		  chunks(count, [key, index, next_key, next_index, histogram, shift, n, chunk](size_t i) {
+			  size_t* const buckets = histogram+i*_radix_buckets;
+			  const size_t end = std::min((i+1)*chunk, n);
+			  for (size_t j=i*chunk; j<end; ++j) {
+				const size_t position = buckets[(key[j] >> shift) & (_radix_buckets-1)]++;
+				next_key[position] = key[j];
+				next_index[position] = index[j];
+			  }
+			});
+		  std::swap(key, next_key);
+		  std::swap(index, next_index);
+		}
+
+		if (index != permutation.data()) permutation.swap(next_permutation);
+	  }
+	};
+
+	template<typename T>
+	class _key_sort<T, false> {
+	public:
+	  template<bool stable, size_t size, class Chunks>
+	  static inline void sort (T* const* columns, size_t n, std::vector<size_t>& permutation, const Chunks&) {
+		std::vector<T> keys(n);
+		for (size_t j=0; j<n; ++j) {
+		  keys[j] = columns[j/size][j%size];
+		  permutation[j] = j;
+		}
+		const auto less = [&keys](size_t a, size_t b) {return keys[a] < keys[b];};
+		if (stable) std::stable_sort(permutation.begin(), permutation.end(), less);
+		else std::sort(permutation.begin(), permutation.end(), less);
+	  }
+	};
+
+	// the size of the largest element type of a tuple of columns.
+
+	template<typename T> class _largest_column;
+
+	template<> class _largest_column<std::tuple<>> {
+	public:
+	  static constexpr size_t value = 0;
+	};
+
+	template<typename T, typename... TN> class _largest_column<std::tuple<T, TN...>> {
+	private:
+	  static constexpr size_t size = sizeof(typename std::remove_pointer<T>::type);
+	  static constexpr size_t rest = _largest_column<std::tuple<TN...>>::value;
+	public:
+	  static constexpr size_t value = size > rest ? size : rest;
+	};
+
+	// apply the permutation to the columns N to M of the container in
+	// place, one column at a time: the elements are gathered into the
+	// scratch buffer in sorted order, and then copied back.
+
+	template<size_t N, size_t M> class _permute_columns {
+	public:
+	  template<class C, class Chunks>
+	  static inline void apply (C& container, const size_t* permutation, char* scratch, const Chunks& chunks) {
+		typedef typename _column_type<C,N>::type T;
+		const size_t size = soa::table_traits<C>::table_size;
+		const size_t n = container.size();
+		const size_t count = chunks.count(n);
+		const size_t chunk = (n+count-1)/count;
+		const std::vector<T*> table_columns = _table_columns<N>(container);
+		T* const* columns = table_columns.data();
+		T* const sorted = reinterpret_cast<T*>(scratch);
+
+		chunks(count, [columns, permutation, sorted, n, chunk](size_t i) {
+			const size_t end = std::min((i+1)*chunk, n);
+			for (size_t j=i*chunk; j<end; ++j) {
+			  const size_t k = permutation[j];
+			  sorted[j] = columns[k/size][k%size];
+			}
+		  });
+		chunks(count, [columns, sorted, n, chunk](size_t i) {
+			const size_t end = std::min((i+1)*chunk, n);
+			for (size_t j=i*chunk; j<end;) {
+			  const size_t run = std::min(size-j%size, end-j);
+			  std::memcpy(columns[j/size]+j%size, sorted+j, run*sizeof(T));
+			  j += run;
+			}
+		  });
+
+		_permute_columns<N+1,M>::apply(container, permutation, scratch, chunks);
+	  }
+	};
+
+	template<size_t M> class _permute_columns<M,M> {
+	public:
+	  template<class C, class Chunks>
+	  static inline void apply (C&, const size_t*, char*, const Chunks&) {}
+	};
+
+	template<size_t I, bool stable, class C, class Chunks>
+	inline void _sort_by_key (C& container, const Chunks& chunks) {
+	  static_assert(soa::table_traits<C>::tabled, "sort_by_key needs a tabled container");
+	  typedef typename std::remove_reference<typename soa::table_traits<C>::table_reference>::type table_type;
+	  typedef typename table_type::columns_type columns_type;
+	  typedef typename _column_type<C,I>::type T;
+	  constexpr size_t size = soa::table_traits<C>::table_size;
+
+	  const size_t n = container.size();
+	  if (n < 2) return;
+	  std::vector<size_t> permutation(n);
+	  _key_sort<T>::template sort<stable, size>(_table_columns<I>(container).data(), n, permutation, chunks);
+	  std::unique_ptr<char[]> scratch(new char[n*_largest_column<columns_type>::value]);
+	  _permute_columns<0, std::tuple_size<columns_type>::value>::apply(container, permutation.data(), scratch.get(), chunks);
+	}
+  }
+
+  // sort the elements of a tabled container by leaf column I, and
+  // move the elements of all other columns along. arithmetic keys are
+  // sorted with a radix sort on the key column only, which is stable,
+  // and the resulting permutation is then applied to one column at a
+  // time, in place, with a scratch buffer for a single column. this
+  // works for dtables as well as for table_vectors. other keys are
+  // sorted with std::sort, or std::stable_sort.
+
+  template<size_t I, class C>
+  inline void sort_by_key(C& container)
+  {
+	_sort_by_key<I, false>(container, _sequential_chunks());
+  }
+
+  template<size_t I, class C>
+  inline void stable_sort_by_key(C& container)
+  {
+	_sort_by_key<I, true>(container, _sequential_chunks());
+  }
+
+}
+
+#endif
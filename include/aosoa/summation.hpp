@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_SUMMATION
+#define AOSOA_SUMMATION
+
+namespace aosoa {
+
+  // compensated sums, for use as accumulators in reduce and its
+  // variants: the accumulating function adds values with +=, and
+  // std::plus or operator+ combines two accumulators. value() returns
+  // the compensated sum.
+  //
+  // the compensation relies on the exact order of the floating-point
+  // operations, so these must not be compiled with -ffast-math or
+  // similar options.
+  //
+  // reduce needs an associative and commutative op. like the
+  // floating-point + itself, adding compensated sums is only so up to
+  // rounding, so the result of reduce can depend on the number of
+  // lanes and, in parallel, on the partition into tasks. use the
+  // deterministic reductions for reproducible results.
+
+  // Kahan summation.
+
+  template<typename T>
+  class kahan_sum {
+  private:
+	T sum, compensation;
+
+  public:
+	kahan_sum (T value = T(0)) : sum(value), compensation(T(0)) {}
+
+	inline kahan_sum& operator+= (T value) {
+	  const T y = value - compensation;
+	  const T t = sum + y;
+	  compensation = (t - sum) - y;
+	  sum = t;
+	  return *this;
+	}
+
+	inline kahan_sum& operator+= (const kahan_sum& that) {
+	  *this += that.sum;
+	  *this += -that.compensation;
+	  return *this;
+	}
+
+	inline kahan_sum operator+ (const kahan_sum& that) const {
+	  kahan_sum result(*this);
+	  return result += that;
+	}
+
+	inline T value () const {return sum - compensation;}
+  };
+
+  // Neumaier's variant of Kahan summation, which stays accurate when
+  // the values that are added are larger than the running sum.
+
+  template<typename T>
+  class neumaier_sum {
+  private:
+	T sum, compensation;
+
+  public:
+	neumaier_sum (T value = T(0)) : sum(value), compensation(T(0)) {}
+
+	inline neumaier_sum& operator+= (T value) {
+	  const T t = sum + value;
+	  const bool larger = (sum < T(0) ? -sum : sum) >= (value < T(0) ? -value : value);
+	  compensation += larger ? (sum - t) + value : (value - t) + sum;
+	  sum = t;
+	  return *this;
+	}
+
+	inline neumaier_sum& operator+= (const neumaier_sum& that) {
+	  *this += that.sum;
+	  compensation += that.compensation;
+	  return *this;
+	}
+
+	inline neumaier_sum operator+ (const neumaier_sum& that) const {
+	  neumaier_sum result(*this);
+	  return result += that;
+	}
+
+	inline T value () const {return sum + compensation;}
+  };
+
+}
+
+#endif
@@ -42,10 +42,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace aosoa  {
 
-  template<class C, size_t B, size_t N>
+  template<class C, size_t B, size_t N, size_t A = SOA_TABLE_ALIGNMENT>
   class table_array {
   public:
 	static constexpr auto table_size = B;
+	static constexpr auto alignment = A;
 
 	typedef C value_type;
 	typedef size_t size_type;
@@ -54,12 +55,12 @@ namespace aosoa  {
 	typedef const value_type& const_reference;
 	typedef value_type* pointer;
 	typedef const value_type* const_pointer;
-	typedef table_iterator<value_type,table_size> iterator;
-	typedef const table_iterator<value_type,table_size> const_iterator;
+	typedef table_iterator<value_type,table_size,alignment> iterator;
+	typedef const table_iterator<value_type,table_size,alignment> const_iterator;
 	typedef std::reverse_iterator<iterator> reverse_iterator;
 	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
-	typedef soa::table<value_type,table_size> table_type;
+	typedef soa::table<value_type,table_size,alignment> table_type;
 	typedef table_type& table_reference;
 	typedef const table_type& const_table_reference;
 	typedef table_type* table_pointer;
@@ -132,9 +133,9 @@ namespace aosoa  {
 }
 
 namespace soa {
-  template<typename T, size_t B, size_t N> class table_traits<aosoa::table_array<T,B,N>> {
+  template<typename T, size_t B, size_t N, size_t A> class table_traits<aosoa::table_array<T,B,N,A>> {
   private:
-	typedef aosoa::table_array<T,B,N> table_array_type;
+	typedef aosoa::table_array<T,B,N,A> table_array_type;
   public:
 	static constexpr auto tabled = true;
 	static constexpr auto table_size = B;
@@ -0,0 +1,329 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_TABLE_DEQUE
+#define AOSOA_TABLE_DEQUE
+
+#include <cstddef>
+
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "soa/aligned_allocator.hpp"
+#include "soa/table.hpp"
+#include "soa/table_traits.hpp"
+#include "aosoa/table_iterator.hpp"
+
+namespace aosoa {
+
+  // random access pointer to the tables of a table_deque, through its
+  // directory of chunks with K tables each.
+
+  template<class T, size_t K>
+  class table_chunk_pointer {
+  public:
+	static constexpr auto chunk_size = K;
+
+	typedef T table_type;
+	typedef ptrdiff_t difference_type;
+
+  private:
+	table_type* const* chunks;
+	difference_type pos;
+
+  public:
+	table_chunk_pointer (table_type* const* chunks = nullptr, difference_type pos = 0) :
+	  chunks(chunks), pos(pos)
+	{}
+
+	template<class U>
+	table_chunk_pointer (const table_chunk_pointer<U,K>& that) :
+	  chunks(that.chunks), pos(that.pos)
+	{}
+
+	inline table_type& operator* () const {return chunks[pos/chunk_size][pos%chunk_size];}
+	inline table_type* operator-> () const {return &**this;}
+
+	inline table_type& operator[] (difference_type n) const {
+	  auto npos = pos+n;
+	  return chunks[npos/chunk_size][npos%chunk_size];
+	}
+
+	inline table_chunk_pointer& operator++ () {++pos; return *this;}
+	inline table_chunk_pointer operator++ (int) {return table_chunk_pointer(chunks, pos++);}
+	inline table_chunk_pointer& operator-- () {--pos; return *this;}
+	inline table_chunk_pointer operator-- (int) {return table_chunk_pointer(chunks, pos--);}
+
+	inline table_chunk_pointer& operator+= (difference_type n) {pos += n; return *this;}
+	inline table_chunk_pointer& operator-= (difference_type n) {pos -= n; return *this;}
+
+	inline table_chunk_pointer operator+ (difference_type n) const {return table_chunk_pointer(chunks, pos+n);}
+	inline table_chunk_pointer operator- (difference_type n) const {return table_chunk_pointer(chunks, pos-n);}
+
+	inline difference_type operator- (const table_chunk_pointer& that) const {return pos-that.pos;}
+
+	inline bool operator== (const table_chunk_pointer& that) const {return pos == that.pos;}
+	inline bool operator!= (const table_chunk_pointer& that) const {return pos != that.pos;}
+	inline bool operator< (const table_chunk_pointer& that) const {return pos < that.pos;}
+	inline bool operator> (const table_chunk_pointer& that) const {return pos > that.pos;}
+	inline bool operator<= (const table_chunk_pointer& that) const {return pos <= that.pos;}
+	inline bool operator>= (const table_chunk_pointer& that) const {return pos >= that.pos;}
+
+	template<class U, size_t L> friend class table_chunk_pointer;
+  };
+
+  // a segmented AOSOA container. tables are allocated in chunks of K
+  // tables, which are never relocated: appending elements is O(1), and
+  // references, table pointers and iterators stay valid until the
+  // elements are removed. the tables are reached through a directory
+  // of chunks, so data() returns a table_chunk_pointer instead of a
+  // plain pointer, which the range loops use like an array of tables.
+
+  template<class C, size_t B, size_t K = 64,
+		   class Allocator = soa::aligned_allocator<soa::table<C,B>>,
+		   size_t A = SOA_TABLE_ALIGNMENT>
+	class table_deque {
+	public:
+	  static constexpr auto table_size = B;
+	  static constexpr auto chunk_size = K;
+	  static constexpr auto alignment = A;
+
+	  static_assert((K & (K-1)) == 0, "chunk size must be a power of two");
+
+	  typedef C value_type;
+	  typedef typename std::allocator_traits<Allocator>::template
+		rebind_alloc<soa::table<C,B,A>> allocator_type;
+	  typedef size_t size_type;
+	  typedef ptrdiff_t difference_type;
+	  typedef value_type& reference;
+	  typedef const value_type& const_reference;
+	  typedef value_type* pointer;
+	  typedef const value_type* const_pointer;
+
+	  typedef soa::table<value_type,table_size,alignment> table_type;
+	  typedef table_type& table_reference;
+	  typedef const table_type& const_table_reference;
+	  typedef table_chunk_pointer<table_type,chunk_size> table_pointer;
+	  typedef table_chunk_pointer<const table_type,chunk_size> const_table_pointer;
+
+	  typedef table_iterator<value_type,table_size,alignment,table_pointer> iterator;
+	  typedef const table_iterator<value_type,table_size,alignment,table_pointer> const_iterator;
+	  typedef std::reverse_iterator<iterator> reverse_iterator;
+	  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	private:
+	  typedef std::allocator_traits<allocator_type> allocator_traits;
+
+	  size_type n;
+	  std::vector<table_type*> chunks;
+	  allocator_type allocator;
+
+	  static size_type tables (size_type count) {
+		return count/table_size+(count%table_size?1:0);
+	  }
+
+	  void allocate_chunks (size_type count) {
+		auto nchunks = tables(count)/chunk_size+(tables(count)%chunk_size?1:0);
+		while (chunks.size() < nchunks) {
+		  auto chunk = allocator_traits::allocate(allocator, chunk_size);
+		  for (size_type i=0; i<chunk_size; ++i) allocator_traits::construct(allocator, chunk+i);
+		  chunks.push_back(chunk);
+		}
+	  }
+
+	  void deallocate_chunks (size_type nchunks) {
+		while (chunks.size() > nchunks) {
+		  allocator_traits::deallocate(allocator, chunks.back(), chunk_size);
+		  chunks.pop_back();
+		}
+	  }
+
+	public:
+	  explicit table_deque (size_type count = 0, const allocator_type& allocator = allocator_type()) :
+		n(count), allocator(allocator)
+	  { allocate_chunks(count); }
+
+	  explicit table_deque (size_type count, const_reference value) :
+		n(count)
+	  { allocate_chunks(count); fill(value); }
+
+	  table_deque (const table_deque& that) :
+		n(that.n), allocator(that.allocator)
+	  {
+		allocate_chunks(n);
+		for (size_type i=0; i<tables(n); ++i) data()[i] = that.data()[i];
+	  }
+
+	  table_deque (table_deque&& that) :
+		n(that.n), chunks(std::move(that.chunks)), allocator(std::move(that.allocator))
+	  { that.n = 0; that.chunks.clear(); }
+
+	  ~table_deque () { deallocate_chunks(0); }
+
+	  table_deque& operator= (const table_deque& that) {
+		if (this != &that) {
+		  n = that.n;
+		  allocate_chunks(n);
+		  for (size_type i=0; i<tables(n); ++i) data()[i] = that.data()[i];
+		}
+		return *this;
+	  }
+
+	  table_deque& operator= (table_deque&& that) {
+		swap(that);
+		return *this;
+	  }
+
+	  void assign (size_type count, const_reference value) {
+		n = count;
+		allocate_chunks(count);
+		fill(value);
+	  }
+
+	  allocator_type get_allocator () const { return allocator; }
+
+	  value_type at (size_type pos) {
+		if (pos >= n) throw std::out_of_range("");
+		return (*this)[pos];
+	  }
+
+	  const value_type at (size_type pos) const {
+		if (pos >= n) throw std::out_of_range("");
+		return (*this)[pos];
+	  }
+
+	  value_type operator[] (size_type pos) {
+		return data()[pos/table_size][pos%table_size];
+	  }
+
+	  const value_type operator[] (size_type pos) const {
+		return data()[pos/table_size][pos%table_size];
+	  }
+
+	  value_type front () { return (*this)[0]; }
+	  const value_type front () const { return (*this)[0]; }
+
+	  value_type back () { return (*this)[n-1]; }
+	  const value_type back () const { return (*this)[n-1]; }
+
+	  table_pointer data () { return table_pointer(chunks.data()); }
+	  const_table_pointer data () const { return const_table_pointer(chunks.data()); }
+
+	  iterator begin() { return iterator(data(), 0); }
+	  const_iterator begin() const { return iterator(table_pointer(chunks.data()), 0); }
+	  const_iterator cbegin() const { return begin(); }
+
+	  iterator end() { return iterator(data()+n/table_size, n%table_size); }
+	  const_iterator end() const { return const_cast<table_deque*>(this)->end(); }
+	  const_iterator cend() const { return end(); }
+
+	  reverse_iterator rbegin() { return reverse_iterator(end()); }
+	  const_reverse_iterator rbegin() const { return reverse_iterator(end()); }
+	  const_reverse_iterator crbegin() const { return reverse_iterator(end()); }
+
+	  reverse_iterator rend() { return reverse_iterator(begin()); }
+	  const_reverse_iterator rend() const { return reverse_iterator(begin()); }
+	  const_reverse_iterator crend() const { return reverse_iterator(begin()); }
+
+	  bool empty () const { return n==0; }
+	  size_type size () const { return n; }
+	  size_type max_size () const { return allocator_traits::max_size(allocator) * table_size; }
+
+	  void reserve (size_type size) { allocate_chunks(size); }
+	  size_type capacity () const { return chunks.size() * chunk_size * table_size; }
+
+	  void shrink_to_fit () {
+		deallocate_chunks(tables(n)/chunk_size+(tables(n)%chunk_size?1:0));
+		chunks.shrink_to_fit();
+	  }
+
+	  void clear () { n = 0; deallocate_chunks(0); }
+
+	  void push_back (const_reference value) {
+		allocate_chunks(n+1);
+		(*this)[n++] = value;
+	  }
+
+	  void push_back (value_type&& value) {
+		allocate_chunks(n+1);
+		(*this)[n++] = std::move(value);
+	  }
+
+	  void pop_back () { n--; }
+
+	  void resize (size_type count) {
+		allocate_chunks(count);
+		n = count;
+	  }
+
+	  void resize (size_type count, const_reference value) {
+		allocate_chunks(count);
+		for (auto i=n; i<count; ++i) (*this)[i] = value;
+		n = count;
+	  }
+
+	  void fill (const_reference value) {
+		for (size_type i=0; i<n/table_size; ++i) {
+		  auto& table = data()[i];
+		  for (size_type j=0; j<table_size; ++j) table[j] = value;
+		}
+		if (n%table_size) {
+		  auto& table = data()[n/table_size];
+		  for (size_type j=0; j<n%table_size; ++j) table[j] = value;
+		}
+	  }
+
+	  void swap (table_deque& that) {
+		std::swap(n, that.n);
+		std::swap(chunks, that.chunks);
+		std::swap(allocator, that.allocator);
+	  }
+
+	};
+}
+
+namespace soa {
+  template<typename T, size_t B, size_t K, class Allocator, size_t A>
+  class table_traits<aosoa::table_deque<T,B,K,Allocator,A>> {
+  private:
+	typedef aosoa::table_deque<T,B,K,Allocator,A> table_deque_type;
+  public:
+	static constexpr auto tabled = true;
+	static constexpr auto table_size = B;
+
+	typedef typename table_deque_type::value_type value_type;
+	typedef typename table_deque_type::table_reference table_reference;
+	typedef typename table_deque_type::const_table_reference const_table_reference;
+  };
+}
+
+#endif
@@ -67,7 +67,11 @@ void cilk_iterate(B start, B end, const F& f) {
 
 namespace aosoa {
 
-  template<class C, size_t B>
+  // TablePointer addresses the tables of the container, by default as
+  // a plain pointer into a contiguous array of tables.
+
+  template<class C, size_t B, size_t A = SOA_TABLE_ALIGNMENT,
+		   class TablePointer = soa::table<C,B,A>*>
   class table_iterator {
   public:
 	static constexpr auto table_size = B;
@@ -78,14 +82,14 @@ namespace aosoa {
 	typedef value_type& reference;
 	typedef std::random_access_iterator_tag iterator_category;
 
-	typedef soa::table<value_type,table_size> table_type;
+	typedef soa::table<value_type,table_size,A> table_type;
 	typedef table_type& table_reference;
-	typedef table_type* table_pointer;
+	typedef TablePointer table_pointer;
 
 	table_pointer table;
 	int index;
 
-	table_iterator(table_pointer table = nullptr, int i = 0) :
+	table_iterator(table_pointer table = table_pointer(), int i = 0) :
 	  table(table), index(i)
 	{}
 
@@ -257,14 +261,14 @@ namespace aosoa {
 	typedef T table_reference;
   };
 
-  template<typename T, size_t N> class table_iterator_traits<table_iterator<T,N>> {
+  template<typename T, size_t N, size_t A, class P> class table_iterator_traits<table_iterator<T,N,A,P>> {
   public:
 	static constexpr auto tabled = true;
 	static constexpr auto table_size = N;
 
 	typedef T value_type;
-	typedef soa::table<value_type,table_size> table_type;
-	typedef table_type* table_pointer;
+	typedef soa::table<value_type,table_size,A> table_type;
+	typedef P table_pointer;
 	typedef table_type& table_reference;
   };
 
@@ -285,6 +289,23 @@ namespace aosoa {
 	  (traits::table_size == traits0::table_size) &&
 	  is_compatibly_tabled_iterator<T, TN...>::value;
   };
+
+  template<typename... T> class is_partly_tabled_iterator;
+
+  template<typename T> class is_partly_tabled_iterator<T> {
+  public:
+	static constexpr auto value = table_iterator_traits<T>::tabled;
+  };
+
+  template<typename T, typename T0, typename... TN> class is_partly_tabled_iterator<T, T0, TN...> {
+  public:
+	static constexpr auto value = table_iterator_traits<T>::tabled || is_partly_tabled_iterator<T0, TN...>::value;
+  };
+
+  template<typename... T> class is_mixed_tabled_iterator {
+  public:
+	static constexpr auto value = is_partly_tabled_iterator<T...>::value && !is_compatibly_tabled_iterator<T...>::value;
+  };
 }
 
 #endif
@@ -32,46 +32,73 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cstddef>
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
+#include <tuple>
 #include <utility>
 #include <vector>
 
-#ifdef __MIC__
-#include "tbb/cache_aligned_allocator.h"
-#endif
-
+#include "soa/aligned_allocator.hpp"
+#include "soa/columns.hpp"
+#include "soa/no_init.hpp"
 #include "soa/table.hpp"
 #include "soa/table_traits.hpp"
 #include "aosoa/table_iterator.hpp"
 
+#ifndef NOTBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
 namespace aosoa {
 
-  template<class C, size_t B, class Allocator =
-#ifdef __MIC__
-		   tbb::cache_aligned_allocator<soa::table<C,B>>
-#else
-		   std::allocator<soa::table<C,B>>
-#endif
-		   >
+  namespace {
+	// copy the elements [from, to) of a table column from source, and
+	// advance source past them.
+
+	class _append_column {
+	private:
+	  size_t from, to;
+
+	public:
+	  _append_column (size_t from, size_t to) : from(from), to(to) {}
+
+	  template<typename T> inline void operator() (T*& column, const T*& source) const {
+		std::copy(source, source+(to-from), column+from);
+		source += to-from;
+	  }
+	};
+  }
+
+  // the allocator is rebound to the table type, so that it can be
+  // combined with a table alignment A other than the default.
+  // new tables are zero-initialized, unless soa::no_init is passed.
+
+  template<class C, size_t B,
+		   class Allocator = soa::aligned_allocator<soa::table<C,B>>,
+		   size_t A = SOA_TABLE_ALIGNMENT>
 	class table_vector {
 	public:
 	  static constexpr auto table_size = B;
+	  static constexpr auto alignment = A;
 
 	  typedef C value_type;
-	  typedef Allocator allocator_type;
+	  typedef typename std::allocator_traits<Allocator>::template
+		rebind_alloc<soa::table<C,B,A>> allocator_type;
 	  typedef size_t size_type;
 	  typedef ptrdiff_t difference_type;
 	  typedef value_type& reference;
 	  typedef const value_type& const_reference;
 	  typedef value_type* pointer;
 	  typedef const value_type* const_pointer;
-	  typedef table_iterator<value_type,table_size> iterator;
-	  typedef const table_iterator<value_type,table_size> const_iterator;
+	  typedef table_iterator<value_type,table_size,alignment> iterator;
+	  typedef const table_iterator<value_type,table_size,alignment> const_iterator;
 	  typedef std::reverse_iterator<iterator> reverse_iterator;
 	  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
-	  typedef soa::table<value_type,table_size> table_type;
+	  typedef soa::table<value_type,table_size,alignment> table_type;
 	  typedef table_type& table_reference;
 	  typedef const table_type& const_table_reference;
 	  typedef table_type* table_pointer;
@@ -79,13 +106,67 @@ namespace aosoa {
 
 	private:
 	  size_type n;
-	  std::vector<table_type, allocator_type> tables;
+	  std::vector<table_type, soa::default_init_allocator<allocator_type>> tables;
+
+	  void value_initialize (size_type first) {
+		std::fill(tables.begin()+first, tables.end(), table_type());
+	  }
+
+#ifndef NOTBB
+	  // f(i, count) initializes the first count elements of table i.
+	  template<typename F>
+	  void parallel_initialize (const F& f) {
+		const auto sdb = n/table_size;
+		const auto smb = n%table_size;
+		tbb::parallel_for
+		  (tbb::blocked_range<size_type>(0, tables.size()),
+		   [&f, sdb, smb](const tbb::blocked_range<size_type>& r) {
+			for (size_type i=r.begin(); i<r.end(); ++i)
+			  f(i, i<sdb ? table_size : smb);
+		  });
+	  }
+#endif
+
+	  // grow by count elements at once, and call f(table, from, to,
+	  // index) for each table, with the new elements [from, to) of the
+	  // table, and the index of element from in the vector. the rest of
+	  // the last table is zero-initialized, as in resize.
+	  template<typename F>
+	  void append_tables (size_type count, const F& f) {
+		auto i = n;
+		resize(n+count, soa::no_init);
+		while (i < n) {
+		  auto& table = tables[i/table_size];
+		  auto from = i%table_size;
+		  auto to = std::min(size_type(table_size), from+(n-i));
+		  f(table, from, to, i);
+		  i += to-from;
+		}
+		if (n%table_size)
+		  soa::value_initialize_columns(tables[n/table_size].columns(), n%table_size, table_size);
+	  }
 
 	public:
 	  explicit table_vector (size_type count = 0) :
 		n(count), tables(count/table_size+(count%table_size?1:0))
+	  { value_initialize(0); }
+
+	  table_vector (size_type count, soa::no_init_t) :
+		n(count), tables(count/table_size+(count%table_size?1:0))
 	  {}
 
+#ifndef NOTBB
+	  table_vector (size_type count, soa::parallel_init_t) :
+		n(count), tables(count/table_size+(count%table_size?1:0))
+	  {
+		parallel_initialize([this](size_type i, size_type) {tables[i] = table_type();});
+	  }
+
+	  table_vector (size_type count, const_reference value, soa::parallel_init_t) :
+		n(count), tables(count/table_size+(count%table_size?1:0))
+	  { parallel_fill(value); }
+#endif
+
 	  explicit table_vector (size_type count, const_reference value) :
 		n(count), tables(count/table_size+(count%table_size?1:0))
 	  { fill(value); }
@@ -116,6 +197,14 @@ namespace aosoa {
 		fill(value);
 	  }
 
+#ifndef NOTBB
+	  void parallel_assign (size_type count, const_reference value) {
+		n = count;
+		tables.resize(count/table_size+(count%table_size?1:0));
+		parallel_fill(value);
+	  }
+#endif
+
 	  allocator_type get_allocator () const { return tables.get_allocator(); }
 
 	  value_type at (size_type pos) {
@@ -182,15 +271,54 @@ namespace aosoa {
 		(*this)[m] = std::move(value);
 	  }
 
+	  // append the elements [first, last), which must be assignable to value_type.
+	  template<class ForwardIt>
+	  void append (ForwardIt first, ForwardIt last) {
+		append_tables(std::distance(first, last),
+					  [&first](table_reference table, size_type from, size_type to, size_type) {
+						for (auto j=from; j<to; ++j, ++first) table[j] = *first;
+					  });
+	  }
+
+	  // append count elements, and call f(index, element) to initialize each of them.
+	  template<typename F>
+	  void append_n (size_type count, const F& f) {
+		append_tables(count, [&f](table_reference table, size_type from, size_type to, size_type index) {
+			for (auto j=from; j<to; ++j) {
+			  auto element = table[j];
+			  f(index+j-from, element);
+			}
+		  });
+	  }
+
+	  // append count elements from one array per leaf field, passed in
+	  // the order of the flattened value_type::reference::type.
+	  template<typename... Columns>
+	  void append_columns (size_type count, const Columns*... columns) {
+		static_assert(sizeof...(Columns) == std::tuple_size<typename table_type::columns_type>::value,
+					  "one column per leaf field");
+		auto sources = std::make_tuple(columns...);
+		append_tables(count, [&sources](table_reference table, size_type from, size_type to, size_type) {
+			soa::for_each_column(table.columns(), sources, _append_column(from, to));
+		  });
+	  }
+
 	  void pop_back () { n--; }
 
 	  void resize (size_type count) {
 		if (n != count) {
+		  auto o = tables.size();
 		  n = count;
 		  tables.resize(count/table_size+(count%table_size?1:0));
+		  if (o < tables.size()) value_initialize(o);
 		}
 	  }
 
+	  void resize (size_type count, soa::no_init_t) {
+		n = count;
+		tables.resize(count/table_size+(count%table_size?1:0));
+	  }
+
 	  void resize (size_type count, const_reference value) {
 		auto o = n;
 		n = count;
@@ -230,6 +358,15 @@ namespace aosoa {
 		}
 	  }
 
+#ifndef NOTBB
+	  void parallel_fill (const_reference value) {
+		parallel_initialize([this, &value](size_type i, size_type count) {
+			auto& table = tables[i];
+			for (size_type j=0; j<count; ++j) table[j] = value;
+		  });
+	  }
+#endif
+
 	  void swap (table_vector& that) {
 		std::swap(n, that.n);
 		std::swap(tables, that.tables);
@@ -239,9 +376,9 @@ namespace aosoa {
 }
 
 namespace soa {
-  template<typename T, size_t B> class table_traits<aosoa::table_vector<T,B>> {
+  template<typename T, size_t B, class Allocator, size_t A> class table_traits<aosoa::table_vector<T,B,Allocator,A>> {
   private:
-	typedef aosoa::table_vector<T,B> table_vector_type;
+	typedef aosoa::table_vector<T,B,Allocator,A> table_vector_type;
   public:
 	static constexpr auto tabled = true;
 	static constexpr auto table_size = B;
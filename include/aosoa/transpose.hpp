@@ -0,0 +1,198 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef AOSOA_TRANSPOSE
+#define AOSOA_TRANSPOSE
+
+#include <cstddef>
+#include <cstring>
+
+#include <tuple>
+#include <type_traits>
+
+#include "soa/columns.hpp"
+#include "soa/table_traits.hpp"
+
+#include "aosoa/indexed_for_each_range.hpp"
+
+#ifndef NOTBB
+#include "aosoa/parallel_indexed_for_each_range.hpp"
+#endif
+
+namespace aosoa {
+
+  namespace {
+	// size of a struct with the leaf fields of a flattened reference
+	// type as members, in the same order, with natural alignment.
+
+	template<size_t Offset, size_t Alignment, typename T> class _record_size;
+
+	template<size_t Offset, size_t Alignment> class _record_size<Offset, Alignment, std::tuple<>> {
+	public:
+	  static constexpr size_t value = (Offset+Alignment-1)/Alignment*Alignment;
+	};
+
+	template<size_t Offset, size_t Alignment, typename Head, typename... Tail>
+	class _record_size<Offset, Alignment, std::tuple<Head, Tail...>> {
+	private:
+	  typedef typename std::remove_reference<Head>::type field_type;
+	  static constexpr size_t offset = (Offset+alignof(field_type)-1)/alignof(field_type)*alignof(field_type);
+	  static constexpr size_t alignment = Alignment < alignof(field_type) ? alignof(field_type) : Alignment;
+	public:
+	  static constexpr size_t value = _record_size<offset+sizeof(field_type), alignment, std::tuple<Tail...>>::value;
+	};
+
+	// copy the elements [from, to) of each column from or to the
+	// corresponding fields of records of Stride bytes. the field
+	// offsets follow the natural struct layout, as in _record_size.
+
+	template<size_t Stride> class _record_column {
+	protected:
+	  size_t from, to, offset;
+
+	  template<typename T> inline size_t next_offset () {
+		offset = (offset+alignof(T)-1)/alignof(T)*alignof(T);
+		auto result = offset;
+		offset += sizeof(T);
+		return result;
+	  }
+
+	public:
+	  _record_column (size_t from, size_t to) : from(from), to(to), offset(0) {}
+	};
+
+	template<size_t Stride> class _from_record_column : public _record_column<Stride> {
+	private:
+	  const char* records;
+
+	public:
+	  _from_record_column (const char* records, size_t from, size_t to) :
+		_record_column<Stride>(from, to), records(records)
+	  {}
+
+	  template<typename T> inline void operator() (T* column) {
+		auto field = records + this->template next_offset<T>();
+		for (size_t j=this->from; j<this->to; ++j)
+		  std::memcpy(&column[j], field+j*Stride, sizeof(T));
+	  }
+	};
+
+	template<size_t Stride> class _to_record_column : public _record_column<Stride> {
+	private:
+	  char* records;
+
+	public:
+	  _to_record_column (char* records, size_t from, size_t to) :
+		_record_column<Stride>(from, to), records(records)
+	  {}
+
+	  template<typename T> inline void operator() (T* column) {
+		auto field = records + this->template next_offset<T>();
+		for (size_t j=this->from; j<this->to; ++j)
+		  std::memcpy(field+j*Stride, &column[j], sizeof(T));
+	  }
+	};
+
+	template<class T, class C> class _transpose {
+	public:
+	  typedef typename soa::table_traits<C>::table_reference table_reference;
+
+	  static_assert(std::is_standard_layout<T>::value, "records must have standard layout");
+	  // only the size of the records can be checked: the order of
+	  // their fields is up to the caller.
+	  static_assert(sizeof(T) == _record_size<0, 1, typename soa::table_traits<C>::value_type::reference::type>::value,
+					"records must have the size of a struct with the leaf fields of the value type as members");
+
+	  static inline void from_aos (const T* records, size_t start, size_t end, size_t index, table_reference table) {
+		soa::for_each_column(table.columns(), _from_record_column<sizeof(T)>
+							 (reinterpret_cast<const char*>(records+index), start, end));
+	  }
+
+	  static inline void to_aos (T* records, size_t start, size_t end, size_t index, table_reference table) {
+		soa::for_each_column(table.columns(), _to_record_column<sizeof(T)>
+							 (reinterpret_cast<char*>(records+index), start, end));
+	  }
+	};
+  }
+
+  // copy container.size() records, in the layout of a struct that has
+  // the leaf fields of the value type as members, in the order of the
+  // flattened reference type, into a tabled container, column by column.
+  // only the total size of the records is checked, so the caller must
+  // keep the fields in that order: a record with the same fields in a
+  // different order, but of the same size, is copied into the wrong
+  // columns.
+
+  template<class T, class C>
+  inline void from_aos(const T* records, C& container)
+  {
+	typedef _transpose<T,C> transpose;
+	indexed_for_each_range([records](size_t start, size_t end, size_t index,
+									 typename transpose::table_reference table) {
+							 transpose::from_aos(records, start, end, index, table);
+						   }, container);
+  }
+
+  // the inverse of from_aos.
+
+  template<class T, class C>
+  inline void to_aos(C& container, T* records)
+  {
+	typedef _transpose<T,C> transpose;
+	indexed_for_each_range([records](size_t start, size_t end, size_t index,
+									 typename transpose::table_reference table) {
+							 transpose::to_aos(records, start, end, index, table);
+						   }, container);
+  }
+
+#ifndef NOTBB
+  template<class T, class C>
+  inline void parallel_from_aos(const T* records, C& container)
+  {
+	typedef _transpose<T,C> transpose;
+	parallel_indexed_for_each_range([records](size_t start, size_t end, size_t index,
+											  typename transpose::table_reference table) {
+									  transpose::from_aos(records, start, end, index, table);
+									}, container);
+  }
+
+  template<class T, class C>
+  inline void parallel_to_aos(C& container, T* records)
+  {
+	typedef _transpose<T,C> transpose;
+	parallel_indexed_for_each_range([records](size_t start, size_t end, size_t index,
+											  typename transpose::table_reference table) {
+									  transpose::to_aos(records, start, end, index, table);
+									}, container);
+  }
+#endif
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SOA_ALIGNED_ALLOCATOR
+#define SOA_ALIGNED_ALLOCATOR
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <new>
+
+#include "soa/alignment.hpp"
+
+namespace soa {
+
+  // standard allocator that aligns every allocation to an A-byte
+  // boundary, for column storage that vector loops can access with
+  // aligned loads and stores.
+
+  template<typename T, size_t A = SOA_DEFAULT_ALIGNMENT>
+  class aligned_allocator {
+  public:
+	static constexpr size_t alignment = A < alignof(T) ? alignof(T) : A;
+
+	static_assert((A & (A-1)) == 0, "alignment must be a power of two");
+
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template<typename U> struct rebind {
+	  typedef aligned_allocator<U,A> other;
+	};
+
+	aligned_allocator () {}
+	template<typename U> aligned_allocator (const aligned_allocator<U,A>&) {}
+
+	T* allocate (size_t n) {
+	  void* p = nullptr;
+	  if (posix_memalign(&p, alignment < sizeof(void*) ? sizeof(void*) : alignment, n*sizeof(T)))
+		throw std::bad_alloc();
+	  return static_cast<T*>(p);
+	}
+
+	void deallocate (T* p, size_t) {
+	  free(p);
+	}
+
+	size_type max_size () const { return size_type(-1)/sizeof(T); }
+
+	template<typename U> bool operator== (const aligned_allocator<U,A>&) const { return true; }
+	template<typename U> bool operator!= (const aligned_allocator<U,A>&) const { return false; }
+  };
+
+  template<typename T, size_t A> class allocator_alignment<aligned_allocator<T,A>> {
+  public:
+	static constexpr size_t value = A;
+  };
+
+}
+
+#endif
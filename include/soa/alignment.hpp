@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SOA_ALIGNMENT
+#define SOA_ALIGNMENT
+
+#include <cstddef>
+
+// default alignment of dynamically allocated columns:
+// a cache line, which also covers the vector width up to AVX-512.
+
+#ifndef SOA_DEFAULT_ALIGNMENT
+#define SOA_DEFAULT_ALIGNMENT 64
+#endif
+
+// default alignment of the columns in a soa::table:
+// the vector width of the target instruction set.
+
+#ifndef SOA_TABLE_ALIGNMENT
+#if defined(__AVX512F__) || defined(__MIC__)
+#define SOA_TABLE_ALIGNMENT 64
+#elif defined(__AVX__)
+#define SOA_TABLE_ALIGNMENT 32
+#else
+#define SOA_TABLE_ALIGNMENT 16
+#endif
+#endif
+
+namespace soa {
+
+  // tell the compiler that p is aligned to an A-byte boundary,
+  // so that loops over p can use aligned vector loads and stores.
+
+  template<size_t A, typename T> inline T* assume_aligned (T* p) {
+#if defined(__ICC) || defined(__INTEL_COMPILER)
+	__assume_aligned(p, A);
+	return p;
+#elif defined(__GNUC__)
+	return static_cast<T*>(__builtin_assume_aligned(p, A));
+#else
+	return p;
+#endif
+  }
+
+  // the alignment of a column of n elements of type T in a table
+  // aligned to A bytes: the largest power of two that does not exceed
+  // the size of the column, at most A. small columns are thus not
+  // padded to the full alignment, but never span more vectors than
+  // necessary.
+
+  template<typename T> constexpr size_t column_alignment (size_t n, size_t A, size_t alignment = 1) {
+	return (2*alignment > A) || (2*alignment > n*sizeof(T)) ? (alignment < alignof(T) ? alignof(T) : alignment)
+	  : column_alignment<T>(n, A, 2*alignment);
+  }
+
+  // the alignment an allocator guarantees for the storage it returns,
+  // beyond the natural alignment of the allocated type.
+
+  template<class Allocator> class allocator_alignment {
+  public:
+	static constexpr size_t value = 1;
+  };
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SOA_COLUMN_VIEW
+#define SOA_COLUMN_VIEW
+
+#include <cstddef>
+
+#include <tuple>
+#include <utility>
+
+#include "soa/dtable.hpp"
+#include "soa/table_traits.hpp"
+
+namespace soa {
+
+  // a non-owning view of n elements whose leaf fields are stored in
+  // separate, externally owned arrays. the arrays are passed in the
+  // order of the flattened C::reference::type, and are not assumed to
+  // be aligned. copies of a view refer to the same arrays.
+
+  template<class C>
+  class column_view : protected dtable_base<typename C::reference::type, 1> {
+  private:
+	typedef dtable_base<typename C::reference::type, 1> super;
+
+	size_t n;
+
+  public:
+	column_view () : super(), n(0) {}
+
+	template<typename... Columns>
+	column_view (size_t n, Columns*... columns) :
+	  super(), n(n)
+	{
+	  static_assert(sizeof...(Columns) == std::tuple_size<typename super::columns_type>::value,
+					"one column per leaf field");
+	  super::columns() = std::make_tuple(columns...);
+	}
+
+	inline C operator[] (size_t pos) {return C(super::operator[](pos));}
+	inline const C operator[] (size_t pos) const {return C(super::operator[](pos));}
+
+	C front () {return (*this)[0];}
+	const C front () const {return (*this)[0];}
+
+	C back () {return (*this)[n-1];}
+	const C back () const {return (*this)[n-1];}
+
+	inline column_view* data() {return this;}
+
+	// pointers to the leaf columns, in the order of the flattened
+	// C::reference::type.
+	typedef decltype(column_pointers(std::declval<typename super::columns_type>())) columns_type;
+
+	inline columns_type columns() {return column_pointers(super::columns());}
+
+	inline bool empty() const {return n==0;}
+	inline size_t size() const {return n;}
+  };
+
+  template<typename T> class table_traits<column_view<T>> {
+  public:
+	static constexpr auto tabled = true;
+	static constexpr auto table_size = SIZE_MAX;
+
+	typedef T value_type;
+	typedef column_view<value_type> table_type;
+	typedef table_type& table_reference;
+	typedef const table_type& const_table_reference;
+  };
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SOA_COLUMNS
+#define SOA_COLUMNS
+
+#include <cstddef>
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+
+namespace soa {
+
+  namespace {
+	template<size_t I, size_t N> class _for_each_column {
+	public:
+	  template<typename T, typename F>
+	  static inline void apply (T& columns, F& f) {
+		f(std::get<I>(columns));
+		_for_each_column<I+1,N>::apply(columns, f);
+	  }
+
+	  template<typename T0, typename T1, typename F>
+	  static inline void apply (T0& columns0, T1& columns1, F& f) {
+		f(std::get<I>(columns0), std::get<I>(columns1));
+		_for_each_column<I+1,N>::apply(columns0, columns1, f);
+	  }
+	};
+
+	template<size_t N> class _for_each_column<N,N> {
+	public:
+	  template<typename T, typename F>
+	  static inline void apply (T&, F&) {}
+
+	  template<typename T0, typename T1, typename F>
+	  static inline void apply (T0&, T1&, F&) {}
+	};
+
+	class _value_initialize_column {
+	private:
+	  size_t from, to;
+
+	public:
+	  _value_initialize_column (size_t from, size_t to) : from(from), to(to) {}
+
+	  template<typename T> inline void operator() (T*& column) const {
+		std::fill(column+from, column+to, T());
+	  }
+	};
+  }
+
+  // copy a tuple of references to column pointers, as used inside the
+  // soa containers, into a tuple of column pointers.
+
+  template<typename... T>
+  inline std::tuple<T*...> column_pointers (const std::tuple<T*&...>& columns) {
+	return std::tuple<T*...>(columns);
+  }
+
+  // apply f to each column pointer in a tuple of columns,
+  // as returned by the columns() member of the soa containers.
+
+  template<typename T, typename F>
+  inline void for_each_column (T&& columns, F&& f) {
+	_for_each_column<0, std::tuple_size<typename std::remove_reference<T>::type>::value>::
+	  apply(columns, f);
+  }
+
+  // apply f pairwise to the corresponding column pointers of two
+  // tuples of columns with the same column types.
+
+  template<typename T0, typename T1, typename F>
+  inline void for_each_column (T0&& columns0, T1&& columns1, F&& f) {
+	static_assert(std::tuple_size<typename std::remove_reference<T0>::type>::value ==
+				  std::tuple_size<typename std::remove_reference<T1>::type>::value,
+				  "column tuples must have the same number of columns");
+	_for_each_column<0, std::tuple_size<typename std::remove_reference<T0>::type>::value>::
+	  apply(columns0, columns1, f);
+  }
+
+  // value-initialize the elements [from, to) of each column in a
+  // tuple of columns.
+
+  template<typename T>
+  inline void value_initialize_columns (T&& columns, size_t from, size_t to) {
+	for_each_column(columns, _value_initialize_column(from, to));
+  }
+
+}
+
+#endif
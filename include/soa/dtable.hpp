@@ -31,94 +31,86 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SOA_DTABLE
 
 #include <cstddef>
+#include <cstring>
 
+#include <algorithm>
+#include <memory>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+
+#include "soa/alignment.hpp"
+#include "soa/aligned_allocator.hpp"
+#include "soa/columns.hpp"
+#include "soa/no_init.hpp"
+#include "soa/slab.hpp"
 
 namespace soa {
 
   namespace {
 
-	template<typename T, typename Enable = void> class dtable_base;
+	// A is the alignment guaranteed for the start of each column.
 
-	template<> class dtable_base<std::tuple<>> {
-	public:
-	  dtable_base (size_t n = 0) {}
-	  ~dtable_base () {}
+	template<typename T, size_t A, typename Enable = void> class dtable_base;
 
-	  void allocate (size_t n) {}
-	  void deallocate () {}
+	template<size_t A> class dtable_base<std::tuple<>, A> {
+	public:
+	  typedef std::tuple<> columns_type;
 
 	  inline std::tuple<> operator[](size_t) {return std::tie();}
 	  inline const std::tuple<> operator[](size_t) const {return std::tie();}
+
+	  inline columns_type columns() {return std::tie();}
 	};
 
 #ifndef NVARIADIC
 
-	template<typename Head, typename... Tail>
-	class dtable_base<std::tuple<Head, Tail...>,
+	template<typename Head, typename... Tail, size_t A>
+	class dtable_base<std::tuple<Head, Tail...>, A,
 					  typename std::enable_if<
 						std::is_scalar<
 						  typename std::remove_reference<Head>::type>::value>::type>
-	   : protected dtable_base<std::tuple<Tail...>>
+	   : protected dtable_base<std::tuple<Tail...>, A>
 	{
 	private:
-	  typedef dtable_base<std::tuple<Tail...>> super;
+	  typedef dtable_base<std::tuple<Tail...>, A> super;
 	  typedef typename std::remove_reference<Head>::type field_type;
 
 	  field_type* field;
 
 	public:
-	  dtable_base (size_t n = 0) :
-		super(n),
-		field(n?(new field_type[n]):nullptr)
-	  {}
-
-	  ~dtable_base () {
-		delete [] field;
-	  }
-
-	  void allocate (size_t n) {
-		super::allocate(n);
-		field = new field_type[n];
-	  }
+	  typedef decltype(std::tuple_cat(std::declval<std::tuple<field_type*&>>(),
+									  std::declval<typename super::columns_type>())) columns_type;
 
-	  void deallocate () {
-		delete [] field; field = nullptr;
-		super::deallocate();
-	  }
+	  dtable_base () : super(), field(nullptr) {}
 
 	  inline std::tuple<Head, Tail...> operator[] (size_t pos) {
-		return std::tuple_cat(std::tie(field[pos]), super::operator[](pos));
+		return std::tuple_cat(std::tie(assume_aligned<A>(field)[pos]), super::operator[](pos));
 	  }
 
 	  inline const std::tuple<Head, Tail...> operator[] (size_t pos) const {
-		return std::tuple_cat(std::tie(const_cast<const Head>(field[pos])), super::operator[](pos));
+		return std::tuple_cat(std::tie(const_cast<const Head>(assume_aligned<A>(field)[pos])), super::operator[](pos));
+	  }
+
+	  inline columns_type columns () {
+		return std::tuple_cat(std::tie(field), super::columns());
 	  }
 	};
 
-	template<typename Head, typename... Tail>
-	class dtable_base<std::tuple<Head, Tail...>,
+	template<typename Head, typename... Tail, size_t A>
+	class dtable_base<std::tuple<Head, Tail...>, A,
 					  typename std::enable_if<
 						std::is_class<Head>::value>::type>
-	   : protected dtable_base<std::tuple<Tail...>>
+	   : protected dtable_base<std::tuple<Tail...>, A>
 	{
 	private:
-	  typedef dtable_base<std::tuple<Tail...>> super;
-	  dtable_base<typename Head::reference::type> field;
+	  typedef dtable_base<std::tuple<Tail...>, A> super;
+	  typedef dtable_base<typename Head::reference::type, A> field_base;
+	  field_base field;
 
 	public:
-	  dtable_base (size_t n = 0) : super(n), field(n) {}
-
-	  void allocate (size_t n) {
-		super::allocate(n);
-		field.allocate(n);
-	  }
-
-	  void deallocate () {
-		field.deallocate();
-		super::deallocate();
-	  }
+	  typedef decltype(std::tuple_cat(std::declval<typename field_base::columns_type>(),
+									  std::declval<typename super::columns_type>())) columns_type;
 
 	  inline std::tuple<Head, Tail...> operator[] (size_t pos) {
 		return std::tuple_cat(field[pos], super::operator[](pos));
@@ -127,45 +119,43 @@ namespace soa {
 	  inline const std::tuple<Head, Tail...> operator[] (size_t pos) const {
 		return std::tuple_cat(field[pos], super::operator[](pos));
 	  }
+
+	  inline columns_type columns () {
+		return std::tuple_cat(field.columns(), super::columns());
+	  }
 	};
 
 #else
 
-	template<typename T0>
-	class dtable_base<std::tuple<T0>> {
+	template<typename T0, size_t A>
+	class dtable_base<std::tuple<T0>, A> {
 	private:
 	  typedef typename std::remove_reference<T0>::type field_type0;
 
 	  field_type0* field0;
 
 	public:
-	  dtable_base (size_t n = 0) :
-		field0(n?(new field_type0[n]):nullptr)
-	  {}
-
-	  ~dtable_base () {
-		delete [] field0;
-	  }
-
-	  void allocate (size_t n) {
-		field0 = new field_type0[n];
-	  }
+	  typedef std::tuple<field_type0*&> columns_type;
 
-	  void deallocate () {
-		delete [] field0; field0 = nullptr;
-	  }
+	  dtable_base () :
+		field0(nullptr)
+	  {}
 
 	  inline std::tuple<T0> operator[] (size_t pos) {
-		return std::tie(field0[pos]);
+		return std::tie(assume_aligned<A>(field0)[pos]);
 	  }
 
 	  inline const std::tuple<T0> operator[] (size_t pos) const {
-		return std::tie(const_cast<const T0>(field0[pos]));
+		return std::tie(const_cast<const T0>(assume_aligned<A>(field0)[pos]));
+	  }
+
+	  inline columns_type columns () {
+		return std::tie(field0);
 	  }
 	};
 
-	template<typename T0, typename T1>
-	class dtable_base<std::tuple<T0,T1>> {
+	template<typename T0, typename T1, size_t A>
+	class dtable_base<std::tuple<T0,T1>, A> {
 	private:
 	  typedef typename std::remove_reference<T0>::type field_type0;
 	  typedef typename std::remove_reference<T1>::type field_type1;
@@ -174,38 +164,29 @@ namespace soa {
 	  field_type1* field1;
 
 	public:
-	  dtable_base (size_t n = 0) :
-		field0(n?(new field_type0[n]):nullptr),
-		field1(n?(new field_type1[n]):nullptr)
-	  {}
-
-	  ~dtable_base () {
-		delete [] field1;
-		delete [] field0;
-	  }
-
-	  void allocate (size_t n) {
-		field0 = new field_type0[n];
-		field1 = new field_type1[n];
-	  }
+	  typedef std::tuple<field_type0*&, field_type1*&> columns_type;
 
-	  void deallocate () {
-		delete [] field1; field1 = nullptr;
-		delete [] field0; field0 = nullptr;
-	  }
+	  dtable_base () :
+		field0(nullptr),
+		field1(nullptr)
+	  {}
 
 	  inline std::tuple<T0,T1> operator[] (size_t pos) {
-		return std::tie(field0[pos], field1[pos]);
+		return std::tie(assume_aligned<A>(field0)[pos], assume_aligned<A>(field1)[pos]);
 	  }
 
 	  inline const std::tuple<T0,T1> operator[] (size_t pos) const {
-		return std::tie(const_cast<const T0>(field0[pos]),
-						const_cast<const T1>(field1[pos]));
+		return std::tie(const_cast<const T0>(assume_aligned<A>(field0)[pos]),
+						const_cast<const T1>(assume_aligned<A>(field1)[pos]));
+	  }
+
+	  inline columns_type columns () {
+		return std::tie(field0, field1);
 	  }
 	};
 
-	template<typename T0, typename T1, typename T2>
-	class dtable_base<std::tuple<T0,T1,T2>> {
+	template<typename T0, typename T1, typename T2, size_t A>
+	class dtable_base<std::tuple<T0,T1,T2>, A> {
 	private:
 	  typedef typename std::remove_reference<T0>::type field_type0;
 	  typedef typename std::remove_reference<T1>::type field_type1;
@@ -216,43 +197,31 @@ namespace soa {
 	  field_type2* field2;
 
 	public:
-	  dtable_base (size_t n = 0) :
-		field0(n?(new field_type0[n]):nullptr),
-		field1(n?(new field_type1[n]):nullptr),
-		field2(n?(new field_type2[n]):nullptr)
-	  {}
+	  typedef std::tuple<field_type0*&, field_type1*&, field_type2*&> columns_type;
 
-	  ~dtable_base () {
-		delete [] field2;
-		delete [] field1;
-		delete [] field0;
-	  }
-
-	  void allocate (size_t n) {
-		field0 = new field_type0[n];
-		field1 = new field_type1[n];
-		field2 = new field_type2[n];
-	  }
-
-	  void deallocate () {
-		delete [] field2; field2 = nullptr;
-		delete [] field1; field1 = nullptr;
-		delete [] field0; field0 = nullptr;
-	  }
+	  dtable_base () :
+		field0(nullptr),
+		field1(nullptr),
+		field2(nullptr)
+	  {}
 
 	  inline std::tuple<T0,T1,T2> operator[] (size_t pos) {
-		return std::tie(field0[pos], field1[pos], field2[pos]);
+		return std::tie(assume_aligned<A>(field0)[pos], assume_aligned<A>(field1)[pos], assume_aligned<A>(field2)[pos]);
 	  }
 
 	  inline const std::tuple<T0,T1,T2> operator[] (size_t pos) const {
-		return std::tie(const_cast<const T0>(field0[pos]),
-						const_cast<const T1>(field1[pos]),
-						const_cast<const T2>(field2[pos]));
+		return std::tie(const_cast<const T0>(assume_aligned<A>(field0)[pos]),
+						const_cast<const T1>(assume_aligned<A>(field1)[pos]),
+						const_cast<const T2>(assume_aligned<A>(field2)[pos]));
+	  }
+
+	  inline columns_type columns () {
+		return std::tie(field0, field1, field2);
 	  }
 	};
 
-	template<typename T0, typename T1, typename T2, typename T3>
-	class dtable_base<std::tuple<T0,T1,T2,T3>> {
+	template<typename T0, typename T1, typename T2, typename T3, size_t A>
+	class dtable_base<std::tuple<T0,T1,T2,T3>, A> {
 	private:
 	  typedef typename std::remove_reference<T0>::type field_type0;
 	  typedef typename std::remove_reference<T1>::type field_type1;
@@ -265,48 +234,33 @@ namespace soa {
 	  field_type3* field3;
 
 	public:
-	  dtable_base (size_t n = 0) :
-		field0(n?(new field_type0[n]):nullptr),
-		field1(n?(new field_type1[n]):nullptr),
-		field2(n?(new field_type2[n]):nullptr),
-		field3(n?(new field_type3[n]):nullptr)
-	  {}
+	  typedef std::tuple<field_type0*&, field_type1*&, field_type2*&, field_type3*&> columns_type;
 
-	  ~dtable_base () {
-		delete [] field3;
-		delete [] field2;
-		delete [] field1;
-		delete [] field0;
-	  }
-
-	  void allocate (size_t n) {
-		field0 = new field_type0[n];
-		field1 = new field_type1[n];
-		field2 = new field_type2[n];
-		field3 = new field_type3[n];
-	  }
-
-	  void deallocate () {
-		delete [] field3; field3 = nullptr;
-		delete [] field2; field2 = nullptr;
-		delete [] field1; field1 = nullptr;
-		delete [] field0; field0 = nullptr;
-	  }
+	  dtable_base () :
+		field0(nullptr),
+		field1(nullptr),
+		field2(nullptr),
+		field3(nullptr)
+	  {}
 
 	  inline std::tuple<T0,T1,T2,T3> operator[] (size_t pos) {
-		return std::tie(field0[pos], field1[pos], field2[pos], field3[pos]);
+		return std::tie(assume_aligned<A>(field0)[pos], assume_aligned<A>(field1)[pos], assume_aligned<A>(field2)[pos], assume_aligned<A>(field3)[pos]);
 	  }
 
 	  inline const std::tuple<T0,T1,T2,T3> operator[] (size_t pos) const {
-		return std::tie(const_cast<const T0>(field0[pos]),
-						const_cast<const T1>(field1[pos]),
-						const_cast<const T2>(field2[pos]),
-						const_cast<const T3>(field3[pos]));
+		return std::tie(const_cast<const T0>(assume_aligned<A>(field0)[pos]),
+						const_cast<const T1>(assume_aligned<A>(field1)[pos]),
+						const_cast<const T2>(assume_aligned<A>(field2)[pos]),
+						const_cast<const T3>(assume_aligned<A>(field3)[pos]));
+	  }
+
+	  inline columns_type columns () {
+		return std::tie(field0, field1, field2, field3);
 	  }
 	};
 
-	template<typename T0, typename T1, typename T2, typename T3, typename T4>
-	class dtable_base<std::tuple<T0,T1,T2,T3,T4>> {
+	template<typename T0, typename T1, typename T2, typename T3, typename T4, size_t A>
+	class dtable_base<std::tuple<T0,T1,T2,T3,T4>, A> {
 	private:
 	  typedef typename std::remove_reference<T0>::type field_type0;
 	  typedef typename std::remove_reference<T1>::type field_type1;
@@ -321,70 +275,380 @@ namespace soa {
 	  field_type4* field4;
 
 	public:
-	  dtable_base (size_t n = 0) :
-		field0(n?(new field_type0[n]):nullptr),
-		field1(n?(new field_type1[n]):nullptr),
-		field2(n?(new field_type2[n]):nullptr),
-		field3(n?(new field_type3[n]):nullptr),
-		field4(n?(new field_type4[n]):nullptr)
+	  typedef std::tuple<field_type0*&, field_type1*&, field_type2*&, field_type3*&, field_type4*&> columns_type;
+
+	  dtable_base () :
+		field0(nullptr),
+		field1(nullptr),
+		field2(nullptr),
+		field3(nullptr),
+		field4(nullptr)
 	  {}
 
-	  ~dtable_base () {
-		delete [] field4;
-		delete [] field3;
-		delete [] field2;
-		delete [] field1;
-		delete [] field0;
+	  inline std::tuple<T0,T1,T2,T3,T4> operator[] (size_t pos) {
+		return std::tie(assume_aligned<A>(field0)[pos], assume_aligned<A>(field1)[pos], assume_aligned<A>(field2)[pos], assume_aligned<A>(field3)[pos], assume_aligned<A>(field4)[pos]);
 	  }
 
-	  void allocate (size_t n) {
-		field0 = new field_type0[n];
-		field1 = new field_type1[n];
-		field2 = new field_type2[n];
-		field3 = new field_type3[n];
-		field4 = new field_type4[n];
+	  inline const std::tuple<T0,T1,T2,T3,T4> operator[] (size_t pos) const {
+		return std::tie(const_cast<const T0>(assume_aligned<A>(field0)[pos]),
+						const_cast<const T1>(assume_aligned<A>(field1)[pos]),
+						const_cast<const T2>(assume_aligned<A>(field2)[pos]),
+						const_cast<const T3>(assume_aligned<A>(field3)[pos]),
+						const_cast<const T4>(assume_aligned<A>(field4)[pos]));
 	  }
 
-	  void deallocate () {
-		delete [] field4; field4 = nullptr;
-		delete [] field3; field3 = nullptr;
-		delete [] field2; field2 = nullptr;
-		delete [] field1; field1 = nullptr;
-		delete [] field0; field0 = nullptr;
+	  inline columns_type columns () {
+		return std::tie(field0, field1, field2, field3, field4);
 	  }
+	};
 
-	  inline std::tuple<T0,T1,T2,T3,T4> operator[] (size_t pos) {
-		return std::tie(field0[pos], field1[pos], field2[pos], field3[pos], field4[pos]);
+#endif
+
+	// allocate and free the columns of a dtable_base, by default with
+	// one allocation per column from an allocator that is rebound to
+	// each column type.
+
+	template<class Allocator> class _allocate_column {
+	private:
+	  Allocator& allocator;
+	  size_t n;
+
+	public:
+	  _allocate_column (Allocator& allocator, size_t n) : allocator(allocator), n(n) {}
+
+	  template<typename T> inline void operator() (T*& column) const {
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<T> column_allocator;
+		column_allocator a(allocator);
+		column = std::allocator_traits<column_allocator>::allocate(a, n);
 	  }
+	};
 
-	  inline const std::tuple<T0,T1,T2,T3,T4> operator[] (size_t pos) const {
-		return std::tie(const_cast<const T0>(field0[pos]),
-						const_cast<const T1>(field1[pos]),
-						const_cast<const T2>(field2[pos]),
-						const_cast<const T3>(field3[pos]),
-						const_cast<const T4>(field4[pos]));
+	template<class Allocator> class _deallocate_column {
+	private:
+	  Allocator& allocator;
+	  size_t n;
+
+	public:
+	  _deallocate_column (Allocator& allocator, size_t n) : allocator(allocator), n(n) {}
+
+	  template<typename T> inline void operator() (T*& column) const {
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<T> column_allocator;
+		if (column) {
+		  column_allocator a(allocator);
+		  std::allocator_traits<column_allocator>::deallocate(a, column, n);
+		  column = nullptr;
+		}
 	  }
 	};
 
-#endif
+	template<class Allocator> class _dtable_storage {
+	public:
+	  template<typename Columns>
+	  static void allocate (Allocator& allocator, Columns&& columns, size_t n) {
+		try {
+		  for_each_column(columns, _allocate_column<Allocator>(allocator, n));
+		} catch (...) {
+		  deallocate(allocator, columns, n);
+		  throw;
+		}
+	  }
+
+	  template<typename Columns>
+	  static void deallocate (Allocator& allocator, Columns&& columns, size_t n) {
+		for_each_column(columns, _deallocate_column<Allocator>(allocator, n));
+	  }
+	};
+
+	// with a slab policy, all columns share one allocation.
+
+	template<class Slab> class _slab_size {
+	private:
+	  size_t& bytes;
+	  size_t n;
+
+	public:
+	  _slab_size (size_t& bytes, size_t n) : bytes(bytes), n(n) {}
+
+	  template<typename T> inline void operator() (T*&) const {
+		bytes += Slab::template column_size<T>(n);
+	  }
+	};
+
+	template<class Slab> class _slab_column {
+	private:
+	  char*& p;
+	  size_t n;
+
+	public:
+	  _slab_column (char*& p, size_t n) : p(p), n(n) {}
+
+	  template<typename T> inline void operator() (T*& column) const {
+		column = reinterpret_cast<T*>(p);
+		p += Slab::template column_size<T>(n);
+	  }
+	};
+
+	// copy and initialize the elements [from, to) of columns.
+
+	class _copy_column {
+	private:
+	  size_t from, to;
+
+	public:
+	  _copy_column (size_t from, size_t to) : from(from), to(to) {}
+
+	  template<typename T> inline void operator() (T*& column, T*& that) const {
+		if (to > from) std::memcpy(column+from, that+from, (to-from)*sizeof(T));
+	  }
+	};
+
+	class _clear_column {
+	public:
+	  template<typename T> inline void operator() (T*& column) const {
+		column = nullptr;
+	  }
+	};
+
+	template<size_t Padding, class Allocator> class _dtable_storage<slab<Padding,Allocator>> {
+	private:
+	  typedef slab<Padding,Allocator> slab_type;
+
+	  template<typename Columns>
+	  static size_t slab_size (Columns&& columns, size_t n) {
+		size_t bytes = 0;
+		for_each_column(columns, _slab_size<slab_type>(bytes, n));
+		return bytes;
+	  }
+
+	public:
+	  template<typename Columns>
+	  static void allocate (slab_type& allocator, Columns&& columns, size_t n) {
+		auto p = allocator.allocate(slab_size(columns, n));
+		for_each_column(columns, _slab_column<slab_type>(p, n));
+	  }
+
+	  template<typename Columns>
+	  static void deallocate (slab_type& allocator, Columns&& columns, size_t n) {
+		if (auto p = reinterpret_cast<char*>(std::get<0>(columns))) {
+		  allocator.deallocate(p, slab_size(columns, n));
+		  for_each_column(columns, _clear_column());
+		}
+	  }
+	};
   }
 
-  template<class C>
-  class dtable : protected dtable_base<typename C::reference::type> {
+  template<class C, class Allocator = aligned_allocator<char>>
+  class dtable : protected dtable_base<typename C::reference::type,
+									   allocator_alignment<Allocator>::value> {
+  public:
+	static constexpr size_t alignment = allocator_alignment<Allocator>::value;
+
+	typedef Allocator allocator_type;
+
   private:
-	size_t n;
-	typedef dtable_base<typename C::reference::type> super;
+	typedef dtable_base<typename C::reference::type, alignment> super;
+
+	size_t n, cap;
+	allocator_type allocator;
+
+	void allocate_columns (size_t count) {
+	  if (count) _dtable_storage<allocator_type>::allocate(allocator, super::columns(), count);
+	}
+
+	void deallocate_columns (size_t count) {
+	  _dtable_storage<allocator_type>::deallocate(allocator, super::columns(), count);
+	}
+
+	// copy the elements of that into new columns with room for count elements.
+	dtable (const dtable& that, size_t count) :
+	  super(), n(that.n), cap(count), allocator(that.allocator)
+	{
+	  allocate_columns(cap);
+	  for_each_column(super::columns(), const_cast<dtable&>(that).columns(), _copy_column(0, n));
+	}
+
+	void reallocate (size_t count) {
+	  dtable that(*this, count);
+	  swap(that);
+	}
+
+	size_t grown_capacity (size_t count) const {
+	  return count < 2*cap ? 2*cap : count;
+	}
 
   public:
-	dtable (size_t n = 0) : super(n), n(n) {}
-	void allocate (size_t n) {super::allocate(n);}
-	void deallocate () {super::deallocate();}
+	dtable (size_t n = 0, const allocator_type& allocator = allocator_type()) :
+	  super(), n(n), cap(n), allocator(allocator)
+	{
+	  allocate_columns(n);
+	  value_initialize_columns(super::columns(), 0, n);
+	}
+
+	// leaves the elements uninitialized.
+	dtable (size_t n, no_init_t, const allocator_type& allocator = allocator_type()) :
+	  super(), n(n), cap(n), allocator(allocator)
+	{
+	  allocate_columns(n);
+	}
+
+	// take ownership of the columns of n elements, passed in the order
+	// of the flattened C::reference::type. they must be allocated the
+	// way this dtable allocates them with a capacity of n.
+	template<typename... Columns>
+	dtable (adopt_t, size_t n, Columns*... columns) :
+	  super(), n(n), cap(n), allocator()
+	{
+	  static_assert(sizeof...(Columns) == std::tuple_size<typename super::columns_type>::value,
+					"one column per leaf field");
+	  super::columns() = std::make_tuple(columns...);
+	}
+
+	dtable (const dtable& that) : dtable(that, that.n) {}
+
+	dtable (dtable&& that) noexcept :
+	  super(that), n(that.n), cap(that.cap), allocator(that.allocator)
+	{
+	  static_cast<super&>(that) = super();
+	  that.n = that.cap = 0;
+	}
+
+	~dtable () { deallocate_columns(cap); }
+
+	dtable& operator= (const dtable& that) {
+	  if (this != &that) {
+		if (that.n <= cap) {
+		  for_each_column(super::columns(), const_cast<dtable&>(that).columns(), _copy_column(0, that.n));
+		  n = that.n;
+		} else {
+		  dtable copy(that);
+		  swap(copy);
+		}
+	  }
+	  return *this;
+	}
+
+	dtable& operator= (dtable&& that) noexcept {
+	  if (this != &that) {
+		deallocate();
+		swap(that);
+	  }
+	  return *this;
+	}
+
+	// discard the elements, and allocate uninitialized columns for n elements.
+	void allocate (size_t n) {
+	  deallocate();
+	  allocate_columns(n);
+	  this->n = cap = n;
+	}
+
+	void deallocate () {
+	  deallocate_columns(cap);
+	  n = cap = 0;
+	}
+
+	allocator_type get_allocator () const {return allocator;}
+
 	inline C operator[] (size_t pos) {return C(super::operator[](pos));}
 	inline const C operator[] (size_t pos) const {return C(super::operator[](pos));}
+
+	C front () {return (*this)[0];}
+	const C front () const {return (*this)[0];}
+
+	C back () {return (*this)[n-1];}
+	const C back () const {return (*this)[n-1];}
+
+	inline dtable* data() {return this;}
+
+	// pointers to the leaf columns, in the order of the flattened
+	// C::reference::type.
+	typedef decltype(column_pointers(std::declval<typename super::columns_type>())) columns_type;
+
+	inline columns_type columns() {return column_pointers(super::columns());}
+
+	inline bool empty() const {return n==0;}
 	inline size_t size() const {return n;}
-	inline dtable<C>* data() {return this;}
+	inline size_t capacity() const {return cap;}
+
+	void reserve (size_t count) {
+	  if (count > cap) reallocate(count);
+	}
+
+	void shrink_to_fit () {
+	  if (cap > n) {
+		if (n) reallocate(n); else deallocate();
+	  }
+	}
+
+	void clear () {n = 0;}
+
+	void resize (size_t count) {
+	  if (count > cap) reallocate(grown_capacity(count));
+	  if (count > n) value_initialize_columns(super::columns(), n, count);
+	  n = count;
+	}
+
+	void resize (size_t count, no_init_t) {
+	  if (count > cap) reallocate(grown_capacity(count));
+	  n = count;
+	}
+
+	void resize (size_t count, const C& value) {
+	  if (count > cap) {
+		// value may refer to an element of this dtable
+		dtable that(*this, grown_capacity(count));
+		for (size_t i=n; i<count; ++i) that[i] = value;
+		that.n = count;
+		swap(that);
+	  } else {
+		for (size_t i=n; i<count; ++i) (*this)[i] = value;
+		n = count;
+	  }
+	}
+
+	void push_back (const C& value) {
+	  if (n == cap) {
+		// value may refer to an element of this dtable
+		dtable that(*this, grown_capacity(n+1));
+		that[n] = value;
+		that.n++;
+		swap(that);
+	  } else {
+		(*this)[n] = value;
+		n++;
+	  }
+	}
+
+	// the arguments initialize the leaf fields of the new element
+	// in the order of the flattened C::reference::type.
+	template<typename... Args>
+	void emplace_back (Args&&... args) {
+	  if (n == cap) {
+		dtable that(*this, grown_capacity(n+1));
+		that.super::operator[](n) = std::forward_as_tuple(std::forward<Args>(args)...);
+		that.n++;
+		swap(that);
+	  } else {
+		super::operator[](n) = std::forward_as_tuple(std::forward<Args>(args)...);
+		n++;
+	  }
+	}
+
+	void pop_back () {n--;}
+
+	void swap (dtable& that) noexcept {
+	  std::swap(static_cast<super&>(*this), static_cast<super&>(that));
+	  std::swap(n, that.n);
+	  std::swap(cap, that.cap);
+	  std::swap(allocator, that.allocator);
+	}
   };
 
+  template<class C, class Allocator>
+  inline void swap (dtable<C,Allocator>& lhs, dtable<C,Allocator>& rhs) noexcept {
+	lhs.swap(rhs);
+  }
+
 }
 
 #endif
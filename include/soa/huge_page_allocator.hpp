@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SOA_HUGE_PAGE_ALLOCATOR
+#define SOA_HUGE_PAGE_ALLOCATOR
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include <new>
+
+#include <sys/mman.h>
+
+#include "soa/alignment.hpp"
+
+#ifndef SOA_HUGE_PAGE_SIZE
+#define SOA_HUGE_PAGE_SIZE (2*1024*1024)
+#endif
+
+namespace soa {
+
+  // standard allocator that backs large allocations with huge pages,
+  // to reduce TLB misses when sweeping over many columns. it first
+  // tries explicit huge pages (MAP_HUGETLB), which need to be reserved
+  // by the system administrator, and otherwise maps huge page aligned
+  // memory and asks for transparent huge pages (MADV_HUGEPAGE).
+  // allocations smaller than a huge page are aligned to A bytes.
+
+  template<typename T, size_t A = SOA_DEFAULT_ALIGNMENT>
+  class huge_page_allocator {
+  public:
+	static constexpr size_t huge_page_size = SOA_HUGE_PAGE_SIZE;
+	static constexpr size_t alignment = A < alignof(T) ? alignof(T) : A;
+
+	static_assert((A & (A-1)) == 0, "alignment must be a power of two");
+	static_assert((huge_page_size & (huge_page_size-1)) == 0, "huge page size must be a power of two");
+
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template<typename U> struct rebind {
+	  typedef huge_page_allocator<U,A> other;
+	};
+
+  private:
+	static size_t mapped_size (size_t n) {
+	  return (n*sizeof(T)+huge_page_size-1) & ~(huge_page_size-1);
+	}
+
+	static void* map_huge_pages (size_t bytes) {
+#ifdef MAP_HUGETLB
+	  auto p = mmap(nullptr, bytes, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+	  if (p != MAP_FAILED) return p;
+#endif
+	  // over-allocate, and trim the mapping to a huge page boundary.
+	  auto q = mmap(nullptr, bytes+huge_page_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+	  if (q == MAP_FAILED) throw std::bad_alloc();
+	  auto head = static_cast<char*>(q);
+	  auto body = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(head)+huge_page_size-1) & ~uintptr_t(huge_page_size-1));
+	  if (body != head) munmap(head, body-head);
+	  munmap(body+bytes, head+huge_page_size-body);
+#ifdef MADV_HUGEPAGE
+	  madvise(body, bytes, MADV_HUGEPAGE);
+#endif
+	  return body;
+	}
+
+  public:
+	huge_page_allocator () {}
+	template<typename U> huge_page_allocator (const huge_page_allocator<U,A>&) {}
+
+	T* allocate (size_t n) {
+	  if (n*sizeof(T) < huge_page_size) {
+		void* p = nullptr;
+		if (posix_memalign(&p, alignment < sizeof(void*) ? sizeof(void*) : alignment, n*sizeof(T)))
+		  throw std::bad_alloc();
+		return static_cast<T*>(p);
+	  } else return static_cast<T*>(map_huge_pages(mapped_size(n)));
+	}
+
+	void deallocate (T* p, size_t n) {
+	  if (n*sizeof(T) < huge_page_size) free(p);
+	  else munmap(p, mapped_size(n));
+	}
+
+	size_type max_size () const { return size_type(-1)/sizeof(T); }
+
+	template<typename U> bool operator== (const huge_page_allocator<U,A>&) const { return true; }
+	template<typename U> bool operator!= (const huge_page_allocator<U,A>&) const { return false; }
+  };
+
+  template<typename T, size_t A> class allocator_alignment<huge_page_allocator<T,A>> {
+  public:
+	static constexpr size_t value = A;
+  };
+
+}
+
+#endif
@@ -0,0 +1,247 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SOA_MAPPED_TABLE
+#define SOA_MAPPED_TABLE
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "soa/alignment.hpp"
+#include "soa/dtable.hpp"
+#include "soa/slab.hpp"
+#include "soa/table_traits.hpp"
+
+#ifndef SOA_MAPPED_PAGE_SIZE
+#define SOA_MAPPED_PAGE_SIZE 4096
+#endif
+
+namespace soa {
+
+  namespace {
+	struct _mapped_table_header {
+	  char magic[8];
+	  uint64_t size;
+	  uint64_t columns;
+	  uint64_t bytes;
+	};
+  }
+
+  enum class mapped_mode { read_only, read_write };
+
+  // a fixed-size SOA table whose columns are memory-mapped from a
+  // file, so that the operating system pages them in lazily, and
+  // several processes can share one read-only copy. the file starts
+  // with a header page, followed by the columns in the same layout as
+  // a dtable in a slab, with each column padded to a page boundary.
+  // the layout depends on the leaf field types, so a file is only
+  // portable between processes that use the same C and ABI.
+  //
+  // writing to a table that is opened read-only is undefined.
+
+  template<class C>
+  class mapped_table : protected dtable_base<typename C::reference::type, SOA_MAPPED_PAGE_SIZE> {
+  public:
+	static constexpr size_t alignment = SOA_MAPPED_PAGE_SIZE;
+
+  private:
+	typedef dtable_base<typename C::reference::type, alignment> super;
+	typedef slab<SOA_MAPPED_PAGE_SIZE> layout;
+
+	static constexpr size_t header_size = SOA_MAPPED_PAGE_SIZE;
+	static constexpr size_t ncolumns = std::tuple_size<typename super::columns_type>::value;
+
+	size_t n;
+	char* base;
+	size_t bytes;
+
+	static void fail (const std::string& path, int fd = -1) {
+	  auto error = errno;
+	  if (fd >= 0) close(fd);
+	  throw std::system_error(error, std::system_category(), path);
+	}
+
+	size_t mapped_size (size_t count) {
+	  size_t result = header_size;
+	  for_each_column(super::columns(), _slab_size<layout>(result, count));
+	  return result;
+	}
+
+	void map (int fd, const std::string& path, mapped_mode mode) {
+	  auto p = mmap(nullptr, bytes, mode == mapped_mode::read_write ? PROT_READ|PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	  if (p == MAP_FAILED) fail(path, fd);
+	  close(fd);
+	  base = static_cast<char*>(p);
+	  auto q = base + header_size;
+	  for_each_column(super::columns(), _slab_column<layout>(q, n));
+	}
+
+	void unmap () {
+	  if (base) munmap(base, bytes);
+	  base = nullptr;
+	  for_each_column(super::columns(), _clear_column());
+	}
+
+  public:
+	// create (or truncate) the file at path, with count zero-initialized elements.
+	mapped_table (const std::string& path, size_t count) :
+	  super(), n(count), base(nullptr), bytes(mapped_size(count))
+	{
+	  auto fd = open(path.c_str(), O_RDWR|O_CREAT|O_TRUNC, 0644);
+	  if (fd < 0) fail(path);
+	  if (ftruncate(fd, bytes) < 0) fail(path, fd);
+	  map(fd, path, mapped_mode::read_write);
+	  auto header = reinterpret_cast<_mapped_table_header*>(base);
+	  std::memcpy(header->magic, "SOATABLE", sizeof(header->magic));
+	  header->size = n;
+	  header->columns = ncolumns;
+	  header->bytes = bytes;
+	}
+
+	// open an existing file at path.
+	explicit mapped_table (const std::string& path, mapped_mode mode = mapped_mode::read_only) :
+	  super(), n(0), base(nullptr), bytes(0)
+	{
+	  auto fd = open(path.c_str(), mode == mapped_mode::read_write ? O_RDWR : O_RDONLY);
+	  if (fd < 0) fail(path);
+	  _mapped_table_header header;
+	  struct stat status;
+	  if (fstat(fd, &status) < 0) fail(path, fd);
+	  if (pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+		  std::memcmp(header.magic, "SOATABLE", sizeof(header.magic))) {
+		close(fd);
+		throw std::runtime_error(path + ": not a mapped table");
+	  }
+	  n = header.size;
+	  bytes = mapped_size(n);
+	  if (header.columns != ncolumns || header.bytes != bytes || size_t(status.st_size) < bytes) {
+		close(fd);
+		throw std::runtime_error(path + ": mapped table layout does not match");
+	  }
+	  map(fd, path, mode);
+	}
+
+	mapped_table (const mapped_table&) = delete;
+
+	mapped_table (mapped_table&& that) noexcept :
+	  super(that), n(that.n), base(that.base), bytes(that.bytes)
+	{
+	  static_cast<super&>(that) = super();
+	  that.base = nullptr;
+	  that.n = 0;
+	}
+
+	~mapped_table () { unmap(); }
+
+	mapped_table& operator= (const mapped_table&) = delete;
+
+	mapped_table& operator= (mapped_table&& that) noexcept {
+	  if (this != &that) {
+		unmap();
+		n = 0;
+		swap(that);
+	  }
+	  return *this;
+	}
+
+	inline C operator[] (size_t pos) {return C(super::operator[](pos));}
+	inline const C operator[] (size_t pos) const {return C(super::operator[](pos));}
+
+	C front () {return (*this)[0];}
+	const C front () const {return (*this)[0];}
+
+	C back () {return (*this)[n-1];}
+	const C back () const {return (*this)[n-1];}
+
+	inline mapped_table* data() {return this;}
+
+	// pointers to the leaf columns, in the order of the flattened
+	// C::reference::type.
+	typedef decltype(column_pointers(std::declval<typename super::columns_type>())) columns_type;
+
+	inline columns_type columns() {return column_pointers(super::columns());}
+
+	inline bool empty() const {return n==0;}
+	inline size_t size() const {return n;}
+
+	// pass an madvise hint, such as MADV_WILLNEED, for the whole table.
+	void advise (int advice) const {
+	  if (base) madvise(base, bytes, advice);
+	}
+
+	// write modified pages back to the file.
+	void sync () {
+	  if (base && msync(base, bytes, MS_SYNC) < 0) fail("msync");
+	}
+
+	void swap (mapped_table& that) noexcept {
+	  std::swap(static_cast<super&>(*this), static_cast<super&>(that));
+	  std::swap(n, that.n);
+	  std::swap(base, that.base);
+	  std::swap(bytes, that.bytes);
+	}
+  };
+
+  template<class C>
+  inline void swap (mapped_table<C>& lhs, mapped_table<C>& rhs) noexcept {
+	lhs.swap(rhs);
+  }
+
+  // the loops sweep over the columns sequentially.
+  template<class C>
+  inline void sweep_hint (const mapped_table<C>& table) {
+	table.advise(MADV_SEQUENTIAL);
+  }
+
+  template<typename T> class table_traits<mapped_table<T>> {
+  public:
+	static constexpr auto tabled = true;
+	static constexpr auto table_size = SIZE_MAX;
+
+	typedef T value_type;
+	typedef mapped_table<value_type> table_type;
+	typedef table_type& table_reference;
+	typedef const table_type& const_table_reference;
+  };
+
+}
+
+#endif
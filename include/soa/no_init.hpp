@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SOA_NO_INIT
+#define SOA_NO_INIT
+
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace soa {
+
+  // tag for constructors and resize operations that leave new
+  // elements uninitialized, so that they can be initialized in
+  // parallel, for example with a first-touch loop.
+
+  struct no_init_t {};
+
+  constexpr no_init_t no_init = no_init_t();
+
+  // tag for constructors that initialize the new elements in
+  // parallel, so that the pages of the container are first-touched
+  // by the threads that later compute on them.
+
+  struct parallel_init_t {};
+
+  constexpr parallel_init_t parallel_init = parallel_init_t();
+
+  // tag for constructors that take ownership of existing storage.
+
+  struct adopt_t {};
+
+  constexpr adopt_t adopt = adopt_t();
+
+  // allocator adaptor that default-initializes instead of
+  // value-initializes, which leaves tables with scalar fields
+  // uninitialized. other constructors are forwarded.
+
+  template<class Allocator>
+  class default_init_allocator : public Allocator {
+  private:
+	typedef std::allocator_traits<Allocator> traits;
+
+  public:
+	template<typename U> struct rebind {
+	  typedef default_init_allocator<typename traits::template rebind_alloc<U>> other;
+	};
+
+	default_init_allocator () {}
+	default_init_allocator (const Allocator& allocator) : Allocator(allocator) {}
+
+	template<class U>
+	default_init_allocator (const default_init_allocator<U>& that) :
+	  Allocator(static_cast<const U&>(that))
+	{}
+
+	template<typename U>
+	void construct (U* p) {
+	  ::new(static_cast<void*>(p)) U;
+	}
+
+	template<typename U, typename... Args>
+	void construct (U* p, Args&&... args) {
+	  traits::construct(static_cast<Allocator&>(*this), p, std::forward<Args>(args)...);
+	}
+  };
+
+}
+
+#endif
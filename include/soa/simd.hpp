@@ -0,0 +1,175 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SOA_SIMD
+#define SOA_SIMD
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace soa {
+
+  namespace {
+	template<typename T, size_t N> class _vector {
+	public:
+	  typedef T type __attribute__ ((vector_size (N)));
+	};
+
+	template<size_t N> class _mask_element;
+	template<> class _mask_element<1> {public: typedef int8_t type;};
+	template<> class _mask_element<2> {public: typedef int16_t type;};
+	template<> class _mask_element<4> {public: typedef int32_t type;};
+	template<> class _mask_element<8> {public: typedef int64_t type;};
+  }
+
+  // a short vector of W elements of type T, mapped onto the SSE2,
+  // AVX2 or AVX-512 registers that the target supports by means of
+  // the GCC vector extensions. sizeof(T)*W must be a power of two.
+
+  template<typename T, size_t W>
+  class simd {
+  public:
+	typedef T value_type;
+	static constexpr size_t width = W;
+
+	typedef typename _vector<T, sizeof(T)*W>::type vector_type;
+
+	vector_type v;
+
+	simd () {}
+	simd (vector_type v) : v(v) {}
+	simd (T x) {for (size_t i=0; i<W; ++i) v[i] = x;}
+
+	// unaligned load and store of W elements.
+
+	static inline simd load (const T* p) {
+	  simd result;
+	  std::memcpy(&result.v, p, sizeof(vector_type));
+	  return result;
+	}
+
+	inline void store (T* p) const {
+	  std::memcpy(p, &v, sizeof(vector_type));
+	}
+
+	// masked load and store of the first n < W elements. the other
+	// elements are loaded as zero, and are not stored.
+
+	static inline simd load (const T* p, size_t n) {
+	  simd result(T(0));
+	  std::memcpy(&result.v, p, n*sizeof(T));
+	  return result;
+	}
+
+	inline void store (T* p, size_t n) const {
+	  std::memcpy(p, &v, n*sizeof(T));
+	}
+
+	inline T operator[] (size_t i) const {return v[i];}
+
+	inline simd& operator+= (const simd& that) {v += that.v; return *this;}
+	inline simd& operator-= (const simd& that) {v -= that.v; return *this;}
+	inline simd& operator*= (const simd& that) {v *= that.v; return *this;}
+	inline simd& operator/= (const simd& that) {v /= that.v; return *this;}
+
+	inline simd operator- () const {return simd(-v);}
+
+	inline simd operator+ (const simd& that) const {return simd(v + that.v);}
+	inline simd operator- (const simd& that) const {return simd(v - that.v);}
+	inline simd operator* (const simd& that) const {return simd(v * that.v);}
+	inline simd operator/ (const simd& that) const {return simd(v / that.v);}
+  };
+
+  template<typename T, size_t W>
+  inline simd<T,W> operator+ (T x, const simd<T,W>& y) {return simd<T,W>(x) + y;}
+
+  template<typename T, size_t W>
+  inline simd<T,W> operator- (T x, const simd<T,W>& y) {return simd<T,W>(x) - y;}
+
+  template<typename T, size_t W>
+  inline simd<T,W> operator* (T x, const simd<T,W>& y) {return simd<T,W>(x) * y;}
+
+  template<typename T, size_t W>
+  inline simd<T,W> operator/ (T x, const simd<T,W>& y) {return simd<T,W>(x) / y;}
+
+  // the elements of x moved up by K positions. the K lowest elements
+  // become zero.
+
+  template<size_t K, typename T, size_t W>
+  inline simd<T,W> shift_up (const simd<T,W>& x) {
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__ICC)
+	typedef typename _mask_element<sizeof(T)>::type element;
+	typedef typename _vector<element, sizeof(T)*W>::type mask_type;
+	mask_type mask;
+	for (size_t i=0; i<W; ++i) mask[i] = i < K ? W : i-K;
+	return simd<T,W>(__builtin_shuffle(x.v, simd<T,W>(T(0)).v, mask));
+#else
+	simd<T,W> result(T(0));
+	for (size_t i=K; i<W; ++i) result.v[i] = x.v[i-K];
+	return result;
+#endif
+  }
+
+  namespace {
+	template<size_t K, size_t W> class _prefix_sum {
+	public:
+	  template<typename T>
+	  static inline simd<T,W> step (const simd<T,W>& x) {
+		return _prefix_sum<2*K, W>::step(x + shift_up<K>(x));
+	  }
+	};
+
+	template<size_t W> class _prefix_sum<W, W> {
+	public:
+	  template<typename T>
+	  static inline simd<T,W> step (const simd<T,W>& x) {return x;}
+	};
+  }
+
+  // the inclusive prefix sums of the elements of x, computed in
+  // log2(W) shift and add steps.
+
+  template<typename T, size_t W>
+  inline simd<T,W> prefix_sum (const simd<T,W>& x) {
+	return _prefix_sum<1, W>::step(x);
+  }
+
+  // the sum of the elements of a simd.
+
+  template<typename T, size_t W>
+  inline T sum (const simd<T,W>& x) {
+	T result = x[0];
+	for (size_t i=1; i<W; ++i) result += x[i];
+	return result;
+  }
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2013, Intel Corporation All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+* Neither the name of Intel Corporation nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SOA_SLAB
+#define SOA_SLAB
+
+#include <cstddef>
+
+#include <memory>
+
+#include "soa/alignment.hpp"
+#include "soa/aligned_allocator.hpp"
+
+namespace soa {
+
+  // allocation policy for soa::dtable that places all columns in a
+  // single allocation (a slab). each column starts at a multiple of
+  // Padding bytes from the start of the slab, so pass the cache line
+  // size for compact slabs, or the (huge) page size to give each
+  // column its own pages. the slab itself is obtained from Allocator.
+
+  template<size_t Padding = SOA_DEFAULT_ALIGNMENT,
+		   class Allocator = aligned_allocator<char, Padding>>
+  class slab {
+  public:
+	static constexpr size_t padding = Padding;
+
+	static_assert((Padding & (Padding-1)) == 0, "padding must be a power of two");
+
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<char> allocator_type;
+
+  private:
+	allocator_type allocator;
+
+  public:
+	slab (const allocator_type& allocator = allocator_type()) : allocator(allocator) {}
+
+	// number of bytes a column of n elements of type T occupies in the slab.
+	template<typename T> static constexpr size_t column_size (size_t n) {
+	  return (n*sizeof(T)+Padding-1)/Padding*Padding;
+	}
+
+	char* allocate (size_t bytes) {
+	  return std::allocator_traits<allocator_type>::allocate(allocator, bytes);
+	}
+
+	void deallocate (char* p, size_t bytes) {
+	  std::allocator_traits<allocator_type>::deallocate(allocator, p, bytes);
+	}
+
+	allocator_type get_allocator () const {return allocator;}
+  };
+
+  template<size_t Padding, class Allocator> class allocator_alignment<slab<Padding,Allocator>> {
+  private:
+	static constexpr size_t slab_alignment = allocator_alignment<Allocator>::value;
+  public:
+	static constexpr size_t value = Padding < slab_alignment ? Padding : slab_alignment;
+  };
+
+}
+
+#endif
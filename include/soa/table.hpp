@@ -34,40 +34,46 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <tuple>
 #include <type_traits>
+#include <utility>
+
+#include "soa/alignment.hpp"
 
 namespace soa {
 
   namespace {
 
-	template<typename T, size_t N, typename Enable = void> class table_base;
+	// A is the maximum alignment of the columns, see soa::column_alignment.
+
+	template<typename T, size_t N, size_t A, typename Enable = void> class table_base;
 
-	template<size_t N> class table_base<std::tuple<>, N> {
+	template<size_t N, size_t A> class table_base<std::tuple<>, N, A> {
 	public:
+	  typedef std::tuple<> columns_type;
+
 	  inline std::tuple<> operator[](size_t) {return std::tie();}
 	  inline const std::tuple<> operator[](size_t) const {return std::tie();}
+
+	  inline columns_type columns() {return std::tuple<>();}
 	};
 
 #ifndef NVARIADIC
 
-	template<typename Head, typename... Tail, size_t N> class
-#ifdef __ICC
-#ifdef __MIC__
-	__declspec(align(64))
-#else
-	__declspec(align(32))
-#endif
-#endif
-	table_base<std::tuple<Head, Tail...>, N,
+	template<typename Head, typename... Tail, size_t N, size_t A> class
+	table_base<std::tuple<Head, Tail...>, N, A,
 			   typename std::enable_if<
 				 std::is_scalar<
 				   typename std::remove_reference<Head>::type>::value>::type>
-			: protected table_base<std::tuple<Tail...>, N>
+			: protected table_base<std::tuple<Tail...>, N, A>
 	{
 	private:
-	  typedef table_base<std::tuple<Tail...>, N> super;
-	  typename std::remove_reference<Head>::type field[N];
+	  typedef table_base<std::tuple<Tail...>, N, A> super;
+	  typedef typename std::remove_reference<Head>::type field_type;
+	  alignas(column_alignment<field_type>(N, A)) field_type field[N];
 
 	public:
+	  typedef decltype(std::tuple_cat(std::declval<std::tuple<field_type*>>(),
+									  std::declval<typename super::columns_type>())) columns_type;
+
 	  inline std::tuple<Head, Tail...> operator[] (size_t pos) {
 		return std::tuple_cat(std::tie(field[pos]), super::operator[](pos));
 	  }
@@ -75,19 +81,27 @@ namespace soa {
 	  inline const std::tuple<Head, Tail...> operator[] (size_t pos) const {
 		return std::tuple_cat(std::tie(const_cast<const Head>(field[pos])), super::operator[](pos));
 	  }
+
+	  inline columns_type columns () {
+		return std::tuple_cat(std::make_tuple(&field[0]), super::columns());
+	  }
 	};
 
-	template<typename Head, typename... Tail, size_t N>
-	class table_base<std::tuple<Head, Tail...>, N,
+	template<typename Head, typename... Tail, size_t N, size_t A>
+	class table_base<std::tuple<Head, Tail...>, N, A,
 					 typename std::enable_if<
 					   std::is_class<Head>::value>::type>
-		  : protected table_base<std::tuple<Tail...>, N>
+		  : protected table_base<std::tuple<Tail...>, N, A>
 	{
 	private:
-	  typedef table_base<std::tuple<Tail...>, N> super;
-	  table_base<typename Head::reference::type, N> field;
+	  typedef table_base<std::tuple<Tail...>, N, A> super;
+	  typedef table_base<typename Head::reference::type, N, A> field_type;
+	  field_type field;
 
 	public:
+	  typedef decltype(std::tuple_cat(std::declval<typename field_type::columns_type>(),
+									  std::declval<typename super::columns_type>())) columns_type;
+
 	  inline std::tuple<Head, Tail...> operator[] (size_t pos) {
 		return std::tuple_cat(field[pos], super::operator[](pos));
 	  }
@@ -95,23 +109,23 @@ namespace soa {
 	  inline const std::tuple<Head, Tail...> operator[] (size_t pos) const {
 		return std::tuple_cat(field[pos], super::operator[](pos));
 	  }
+
+	  inline columns_type columns () {
+		return std::tuple_cat(field.columns(), super::columns());
+	  }
 	};
 
 #else
 
-	template<typename T0, size_t N> class
-#ifdef __ICC
-#ifdef __MIC__
-	__declspec(align(64))
-#else
-	__declspec(align(32))
-#endif
-#endif
-	table_base<std::tuple<T0>, N> {
+	template<typename T0, size_t N, size_t A> class
+	table_base<std::tuple<T0>, N, A> {
 	private:
+	  alignas(column_alignment<typename std::remove_reference<T0>::type>(N, A))
 	  typename std::remove_reference<T0>::type field0[N];
 
 	public:
+	  typedef std::tuple<typename std::remove_reference<T0>::type*> columns_type;
+
 	  inline std::tuple<T0> operator[] (size_t pos) {
 		return std::tie(field0[pos]);
 	  }
@@ -119,22 +133,24 @@ namespace soa {
 	  inline const std::tuple<T0> operator[] (size_t pos) const {
 		return std::tie(const_cast<const T0>(field0[pos]));
 	  }
+
+	  inline columns_type columns () {
+		return columns_type(field0);
+	  }
 	};
 
-	template<typename T0, typename T1, size_t N> class
-#ifdef __ICC
-#ifdef __MIC__
-	__declspec(align(64))
-#else
-	__declspec(align(32))
-#endif
-#endif
-	table_base<std::tuple<T0,T1>, N> {
+	template<typename T0, typename T1, size_t N, size_t A> class
+	table_base<std::tuple<T0,T1>, N, A> {
 	private:
+	  alignas(column_alignment<typename std::remove_reference<T0>::type>(N, A))
 	  typename std::remove_reference<T0>::type field0[N];
+	  alignas(column_alignment<typename std::remove_reference<T1>::type>(N, A))
 	  typename std::remove_reference<T1>::type field1[N];
 
 	public:
+	  typedef std::tuple<typename std::remove_reference<T0>::type*,
+						 typename std::remove_reference<T1>::type*> columns_type;
+
 	  inline std::tuple<T0,T1> operator[] (size_t pos) {
 		return std::tie(field0[pos], field1[pos]);
 	  }
@@ -143,23 +159,27 @@ namespace soa {
 		return std::tie(const_cast<const T0>(field0[pos]),
 						const_cast<const T1>(field1[pos]));
 	  }
+
+	  inline columns_type columns () {
+		return columns_type(field0, field1);
+	  }
 	};
 
-	template<typename T0, typename T1, typename T2, size_t N> class
-#ifdef __ICC
-#ifdef __MIC__
-	__declspec(align(64))
-#else
-	__declspec(align(32))
-#endif
-#endif
-	table_base<std::tuple<T0,T1,T2>, N> {
+	template<typename T0, typename T1, typename T2, size_t N, size_t A> class
+	table_base<std::tuple<T0,T1,T2>, N, A> {
 	private:
+	  alignas(column_alignment<typename std::remove_reference<T0>::type>(N, A))
 	  typename std::remove_reference<T0>::type field0[N];
+	  alignas(column_alignment<typename std::remove_reference<T1>::type>(N, A))
 	  typename std::remove_reference<T1>::type field1[N];
+	  alignas(column_alignment<typename std::remove_reference<T2>::type>(N, A))
 	  typename std::remove_reference<T2>::type field2[N];
 
 	public:
+	  typedef std::tuple<typename std::remove_reference<T0>::type*,
+						 typename std::remove_reference<T1>::type*,
+						 typename std::remove_reference<T2>::type*> columns_type;
+
 	  inline std::tuple<T0,T1,T2> operator[] (size_t pos) {
 		return std::tie(field0[pos], field1[pos], field2[pos]);
 	  }
@@ -169,24 +189,30 @@ namespace soa {
 						const_cast<const T1>(field1[pos]),
 						const_cast<const T2>(field2[pos]));
 	  }
+
+	  inline columns_type columns () {
+		return columns_type(field0, field1, field2);
+	  }
 	};
 
-	template<typename T0, typename T1, typename T2, typename T3, size_t N> class
-#ifdef __ICC
-#ifdef __MIC__
-	__declspec(align(64))
-#else
-	__declspec(align(32))
-#endif
-#endif
-	table_base<std::tuple<T0,T1,T2,T3>, N> {
+	template<typename T0, typename T1, typename T2, typename T3, size_t N, size_t A> class
+	table_base<std::tuple<T0,T1,T2,T3>, N, A> {
 	private:
+	  alignas(column_alignment<typename std::remove_reference<T0>::type>(N, A))
 	  typename std::remove_reference<T0>::type field0[N];
+	  alignas(column_alignment<typename std::remove_reference<T1>::type>(N, A))
 	  typename std::remove_reference<T1>::type field1[N];
+	  alignas(column_alignment<typename std::remove_reference<T2>::type>(N, A))
 	  typename std::remove_reference<T2>::type field2[N];
+	  alignas(column_alignment<typename std::remove_reference<T3>::type>(N, A))
 	  typename std::remove_reference<T3>::type field3[N];
 
 	public:
+	  typedef std::tuple<typename std::remove_reference<T0>::type*,
+						 typename std::remove_reference<T1>::type*,
+						 typename std::remove_reference<T2>::type*,
+						 typename std::remove_reference<T3>::type*> columns_type;
+
 	  inline std::tuple<T0,T1,T2,T3> operator[] (size_t pos) {
 		return std::tie(field0[pos], field1[pos], field2[pos], field3[pos]);
 	  }
@@ -197,25 +223,33 @@ namespace soa {
 						const_cast<const T2>(field2[pos]),
 						const_cast<const T3>(field3[pos]));
 	  }
+
+	  inline columns_type columns () {
+		return columns_type(field0, field1, field2, field3);
+	  }
 	};
 
-	template<typename T0, typename T1, typename T2, typename T3, typename T4, size_t N> class
-#ifdef __ICC
-#ifdef __MIC__
-	__declspec(align(64))
-#else
-	__declspec(align(32))
-#endif
-#endif
-	table_base<std::tuple<T0,T1,T2,T3,T4>, N> {
+	template<typename T0, typename T1, typename T2, typename T3, typename T4, size_t N, size_t A> class
+	table_base<std::tuple<T0,T1,T2,T3,T4>, N, A> {
 	private:
+	  alignas(column_alignment<typename std::remove_reference<T0>::type>(N, A))
 	  typename std::remove_reference<T0>::type field0[N];
+	  alignas(column_alignment<typename std::remove_reference<T1>::type>(N, A))
 	  typename std::remove_reference<T1>::type field1[N];
+	  alignas(column_alignment<typename std::remove_reference<T2>::type>(N, A))
 	  typename std::remove_reference<T2>::type field2[N];
+	  alignas(column_alignment<typename std::remove_reference<T3>::type>(N, A))
 	  typename std::remove_reference<T3>::type field3[N];
+	  alignas(column_alignment<typename std::remove_reference<T4>::type>(N, A))
 	  typename std::remove_reference<T4>::type field4[N];
 
 	public:
+	  typedef std::tuple<typename std::remove_reference<T0>::type*,
+						 typename std::remove_reference<T1>::type*,
+						 typename std::remove_reference<T2>::type*,
+						 typename std::remove_reference<T3>::type*,
+						 typename std::remove_reference<T4>::type*> columns_type;
+
 	  inline std::tuple<T0,T1,T2,T3,T4> operator[] (size_t pos) {
 		return std::tie(field0[pos], field1[pos], field2[pos], field3[pos], field4[pos]);
 	  }
@@ -227,28 +261,42 @@ namespace soa {
 						const_cast<const T3>(field3[pos]),
 						const_cast<const T4>(field4[pos]));
 	  }
+
+	  inline columns_type columns () {
+		return columns_type(field0, field1, field2, field3, field4);
+	  }
 	};
 
 #endif
   }
 
-  template<class C, size_t N>
-  class table : protected table_base<typename C::reference::type, N> {
+  // a table block with N elements per column. columns are aligned to
+  // A bytes, or less when they are smaller than A (see column_alignment).
+
+  template<class C, size_t N, size_t A = SOA_TABLE_ALIGNMENT>
+  class table : protected table_base<typename C::reference::type, N, A> {
   private:
-	typedef table_base<typename C::reference::type, N> super;
+	typedef table_base<typename C::reference::type, N, A> super;
 
   public:
+	static constexpr size_t alignment = A;
+
+	// pointers to the N elements of each leaf column, in the order of
+	// the flattened C::reference::type.
+	typedef typename super::columns_type columns_type;
+
 	inline C operator[] (size_t pos) {return C(super::operator[](pos));}
 	inline const C operator[] (size_t pos) const {return C(super::operator[](pos));}
 	inline size_t size() const {return N;}
-	inline table<C,N>* data() {return this;}
+	inline table* data() {return this;}
+	inline columns_type columns() {return super::columns();}
   };
 
 
-  template<class C>
-  class singleton_table : protected table_base<typename C::reference::type, 1> {
+  template<class C, size_t A = SOA_TABLE_ALIGNMENT>
+  class singleton_table : protected table_base<typename C::reference::type, 1, A> {
   private:
-	typedef table_base<typename C::reference::type, 1> super;
+	typedef table_base<typename C::reference::type, 1, A> super;
 
   public:
 	inline C operator() () {return C(super::operator[](0));}
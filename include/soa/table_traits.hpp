@@ -45,24 +45,24 @@ namespace soa {
 
   template<typename T> class table_traits;
 
-  template<typename T, size_t N> class table_traits<soa::table<T,N>> {
+  template<typename T, size_t N, size_t A> class table_traits<soa::table<T,N,A>> {
   public:
 	static constexpr auto tabled = true;
 	static constexpr auto table_size = N;
 
 	typedef T value_type;
-	typedef soa::table<value_type,table_size> table_type;
+	typedef soa::table<value_type,table_size,A> table_type;
 	typedef table_type& table_reference;
 	typedef const table_type& const_table_reference;
   };
 
-  template<typename T> class table_traits<soa::dtable<T>> {
+  template<typename T, class A> class table_traits<soa::dtable<T,A>> {
   public:
 	static constexpr auto tabled = true;
 	static constexpr auto table_size = SIZE_MAX;
 
 	typedef T value_type;
-	typedef soa::dtable<value_type> table_type;
+	typedef soa::dtable<value_type,A> table_type;
 	typedef table_type& table_reference;
 	typedef const table_type& const_table_reference;
   };
@@ -104,6 +104,37 @@ namespace soa {
 	  (traits::table_size == traits0::table_size) &&
 	  is_compatibly_tabled<C, CN...>::value;
   };
+
+  template<class... C> class is_partly_tabled;
+
+  template<class C> class is_partly_tabled<C> {
+  public:
+	static constexpr auto value = table_traits<C>::tabled;
+  };
+
+  template<class C, class C0, class... CN> class is_partly_tabled<C, C0, CN...> {
+  public:
+	static constexpr auto value = table_traits<C>::tabled || is_partly_tabled<C0, CN...>::value;
+  };
+
+  // some containers are tabled, but not all with the same table size.
+
+  template<class... C> class is_mixed_tabled {
+  public:
+	static constexpr auto value = is_partly_tabled<C...>::value && !is_compatibly_tabled<C...>::value;
+  };
+
+  // called by the container loops before they sweep over their
+  // containers. does nothing by default; containers can overload
+  // sweep_hint in their own namespace, for example to issue madvise
+  // hints for memory-mapped columns.
+
+  template<class C> inline void sweep_hint(const C&) {}
+
+  template<class... CN> inline void sweep_hints(const CN&... containers) {
+	int hints[] = {0, (sweep_hint(containers), 0)...};
+	(void)hints;
+  }
 }
 
 #endif
@@ -30,9 +30,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "soa/reference_type.hpp"
 #include "soa/table.hpp"
 #include "soa/dtable.hpp"
+#include "soa/column_view.hpp"
+#include "soa/mapped_table.hpp"
 
 #include "aosoa/table_array.hpp"
 #include "aosoa/table_vector.hpp"
+#include "aosoa/table_deque.hpp"
 
 #include "aosoa/for_each.hpp"
 #include "aosoa/for_each_range.hpp"
@@ -43,13 +46,31 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "aosoa/parallel_for_each_range.hpp"
 #include "aosoa/parallel_indexed_for_each.hpp"
 #include "aosoa/parallel_indexed_for_each_range.hpp"
-
+#include "aosoa/transpose.hpp"
+#include "aosoa/copy.hpp"
+#include "aosoa/pack_for_each.hpp"
+#include "aosoa/reduce.hpp"
+#include "aosoa/parallel_reduce.hpp"
+#include "aosoa/summation.hpp"
+#include "aosoa/scan.hpp"
+#include "aosoa/parallel_scan.hpp"
+#include "aosoa/compact.hpp"
+#include "aosoa/parallel_compact.hpp"
+#include "aosoa/sort.hpp"
+#include "aosoa/parallel_sort.hpp"
+#include "aosoa/gather.hpp"
+#include "aosoa/for_each_pair.hpp"
+#include "aosoa/parallel_for_each_pair.hpp"
+
+#include <cstdio>
 #include <array>
+#include <functional>
 #include <vector>
 
 #include <iostream>
 
 #include "tbb/atomic.h"
+#include "tbb/task_arena.h"
 
 //#define NO_ITERATORS
 
@@ -509,9 +530,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
 
   aosoa::indexed_for_each_range
 	([](size_t start, size_t end, size_t offset,
-		typename soa::table_traits<C0>::table_reference t0,
-		typename soa::table_traits<C1>::table_reference t1,
-		typename soa::table_traits<C2>::table_reference t2) {
+		typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+		typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+		typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2) {
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x = offset+i;
 		t0[i].y = offset+i;
@@ -529,9 +550,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
 
   aosoa::for_each_range
 	([&result](size_t start, size_t end,
-			   typename soa::table_traits<C0>::table_reference t0,
-			   typename soa::table_traits<C1>::table_reference t1,
-			   typename soa::table_traits<C2>::table_reference t2){
+			   typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+			   typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+			   typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2){
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x += t0[i].y + t0[i].z;
 		t1[i].x += t1[i].y + t1[i].z;
@@ -554,9 +575,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
   aosoa::indexed_for_each_range
 	(c0.begin(), c0.end(),
 	 [](size_t start, size_t end, size_t offset,
-		typename soa::table_traits<C0>::table_reference t0,
-		typename soa::table_traits<C1>::table_reference t1,
-		typename soa::table_traits<C2>::table_reference t2) {
+		typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+		typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+		typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2) {
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x = offset+i;
 		t0[i].y = offset+i;
@@ -575,9 +596,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
   aosoa::for_each_range
 	(c0.begin(), c0.end(),
 	 [&result](size_t start, size_t end,
-			   typename soa::table_traits<C0>::table_reference t0,
-			   typename soa::table_traits<C1>::table_reference t1,
-			   typename soa::table_traits<C2>::table_reference t2) {
+			   typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+			   typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+			   typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2) {
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x += t0[i].y + t0[i].z;
 		t1[i].x += t1[i].y + t1[i].z;
@@ -657,9 +678,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
 
   aosoa::parallel_indexed_for_each_range
 	([](size_t start, size_t end, size_t offset,
-		typename soa::table_traits<C0>::table_reference t0,
-		typename soa::table_traits<C1>::table_reference t1,
-		typename soa::table_traits<C2>::table_reference t2) {
+		typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+		typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+		typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2) {
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x = offset+i;
 		t0[i].y = offset+i;
@@ -677,9 +698,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
 
   aosoa::parallel_for_each_range
 	([&result](size_t start, size_t end,
-			   typename soa::table_traits<C0>::table_reference t0,
-			   typename soa::table_traits<C1>::table_reference t1,
-			   typename soa::table_traits<C2>::table_reference t2){
+			   typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+			   typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+			   typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2){
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x += t0[i].y + t0[i].z;
 		t1[i].x += t1[i].y + t1[i].z;
@@ -702,9 +723,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
   aosoa::parallel_indexed_for_each_range
 	(c0.begin(), c0.end(),
 	 [](size_t start, size_t end, size_t offset,
-		typename soa::table_traits<C0>::table_reference t0,
-		typename soa::table_traits<C1>::table_reference t1,
-		typename soa::table_traits<C2>::table_reference t2) {
+		typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+		typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+		typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2) {
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x = offset+i;
 		t0[i].y = offset+i;
@@ -723,9 +744,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
   aosoa::parallel_for_each_range
 	(c0.begin(), c0.end(),
 	 [&result](size_t start, size_t end,
-			   typename soa::table_traits<C0>::table_reference t0,
-			   typename soa::table_traits<C1>::table_reference t1,
-			   typename soa::table_traits<C2>::table_reference t2) {
+			   typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+			   typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+			   typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2) {
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x += t0[i].y + t0[i].z;
 		t1[i].x += t1[i].y + t1[i].z;
@@ -807,9 +828,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
 
   aosoa::cilk_parallel_indexed_for_each_range
 	([](size_t start, size_t end, size_t offset,
-		typename soa::table_traits<C0>::table_reference t0,
-		typename soa::table_traits<C1>::table_reference t1,
-		typename soa::table_traits<C2>::table_reference t2) {
+		typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+		typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+		typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2) {
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x = offset+i;
 		t0[i].y = offset+i;
@@ -827,9 +848,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
 
   aosoa::cilk_parallel_for_each_range
 	([&result](size_t start, size_t end,
-			   typename soa::table_traits<C0>::table_reference t0,
-			   typename soa::table_traits<C1>::table_reference t1,
-			   typename soa::table_traits<C2>::table_reference t2){
+			   typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+			   typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+			   typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2){
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x += t0[i].y + t0[i].z;
 		t1[i].x += t1[i].y + t1[i].z;
@@ -852,9 +873,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
   aosoa::cilk_parallel_indexed_for_each_range
 	(c0.begin(), c0.end(),
 	 [](size_t start, size_t end, size_t offset,
-		typename soa::table_traits<C0>::table_reference t0,
-		typename soa::table_traits<C1>::table_reference t1,
-		typename soa::table_traits<C2>::table_reference t2) {
+		typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+		typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+		typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2) {
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x = offset+i;
 		t0[i].y = offset+i;
@@ -873,9 +894,9 @@ bool testmulti(C0& c0, C1& c1, C2& c2) {
   aosoa::cilk_parallel_for_each_range
 	(c0.begin(), c0.end(),
 	 [&result](size_t start, size_t end,
-			   typename soa::table_traits<C0>::table_reference t0,
-			   typename soa::table_traits<C1>::table_reference t1,
-			   typename soa::table_traits<C2>::table_reference t2) {
+			   typename aosoa::range_table_reference<C0, C0, C1, C2>::type t0,
+			   typename aosoa::range_table_reference<C1, C0, C1, C2>::type t1,
+			   typename aosoa::range_table_reference<C2, C0, C1, C2>::type t2) {
 	  for (size_t i=start; i<end; ++i) {
 		t0[i].x += t0[i].y + t0[i].z;
 		t1[i].x += t1[i].y + t1[i].z;
@@ -920,6 +941,94 @@ bool flatDSOA() {
   std::cout << "\nflat dynamic SOA array\n";
   return test(array);
 }
+
+bool flatDSOAS() {
+  soa::dtable<Cref,soa::slab<>> array(len);
+  std::cout << "\nflat dynamic SOA array in a slab\n";
+  return test(array);
+}
+
+soa::dtable<Cref> make_dtable(size_t n) {
+  soa::dtable<Cref> result(n);
+  return result;
+}
+
+bool flatDSOAC() {
+  soa::dtable<Cref> original(make_dtable(len));
+  for (size_t i=0; i<len; ++i) {original[i].x = i; original[i].y = 2*i; original[i].z = 3*i;}
+  auto copied = [](soa::dtable<Cref>& array, size_t n) {
+	bool all_fine = array.size() == n;
+	for (size_t i=0; all_fine && i<n; ++i)
+	  all_fine = array[i].x == i && array[i].y == 2*i && array[i].z == 3*i;
+	return all_fine;
+  };
+
+  soa::dtable<Cref> array(original);
+  bool all_fine = copied(array, len);
+  array[0].x = 1;
+  all_fine = all_fine && original[0].x == 0;
+  array[0].x = 0;
+
+  // assign to smaller and larger dtables.
+  soa::dtable<Cref> smaller(len/2), larger(2*len);
+  smaller = original;
+  larger = original;
+  all_fine = all_fine && copied(smaller, len) && copied(larger, len);
+
+  soa::dtable<Cref> moved(3);
+  moved = std::move(larger);
+  all_fine = all_fine && copied(moved, len) && larger.size() == 0;
+  soa::dtable<Cref> target(std::move(moved));
+  all_fine = all_fine && copied(target, len) && moved.size() == 0;
+
+  soa::dtable<Cref> other(5);
+  for (size_t i=0; i<5; ++i) other[i].x = other[i].y = other[i].z = 7;
+  swap(target, other);
+  all_fine = all_fine && copied(other, len) && target.size() == 5 && target[4].z == 7;
+
+  std::cout << "\nflat dynamic SOA array copied and moved:   ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return test(array) && all_fine;
+}
+
+bool flatDSOAG() {
+  soa::dtable<Cref> array;
+  for (size_t i=0; i<len; ++i) array.emplace_back(i, i, i);
+  std::cout << "\nflat dynamic SOA array grown with emplace_back\n";
+  return test(array);
+}
+
+bool flatDSOAU() {
+  soa::dtable<Cref> array(len, soa::no_init);
+  std::cout << "\nflat dynamic SOA array, uninitialized\n";
+  return test(array);
+}
+
+bool flatMSOA() {
+  bool result;
+  {
+	soa::mapped_table<Cref> array("utests.soa", len);
+	std::cout << "\nflat memory-mapped SOA array\n";
+	result = test(array);
+  }
+  std::remove("utests.soa");
+  return result;
+}
+
+bool flatVSOA() {
+  std::vector<size_t> x(len), y(len), z(len);
+  soa::column_view<Cref> array(len, x.data(), y.data(), z.data());
+  std::cout << "\nflat SOA view of external columns\n";
+  return test(array);
+}
+
+bool flatDSOAA() {
+  soa::aligned_allocator<size_t> allocator;
+  soa::dtable<Cref> array(soa::adopt, len, allocator.allocate(len), allocator.allocate(len), allocator.allocate(len));
+  std::cout << "\nflat dynamic SOA array with adopted columns\n";
+  return test(array);
+}
 #endif
 
 bool nestedSOA1() {
@@ -964,6 +1073,372 @@ bool nestedSOVB() {
   return test(array);
 }
 
+bool nestedSOVU() {
+  aosoa::table_vector<Cref,tablesize> array(len, soa::no_init);
+  std::cout << "\ntable vector with table size " << tablesize << ", uninitialized" << std::endl;
+  return test(array);
+}
+
+bool nestedSOVR() {
+  aosoa::table_vector<Cref,tablesize> array(1000);
+  for (size_t i=0; i<1000; ++i) array[i].x = array[i].y = array[i].z = i+1;
+  array.resize(10);
+  array.resize(1000);
+
+  // the elements of the first table that were cut off are not reset,
+  // but the tables that were removed come back zero-initialized.
+  bool all_fine = array.size() == 1000;
+  for (size_t i=0; i<10; ++i)
+	all_fine = all_fine && array[i].x == i+1 && array[i].y == i+1 && array[i].z == i+1;
+  for (size_t i=tablesize; i<1000; ++i)
+	all_fine = all_fine && array[i].x == 0 && array[i].y == 0 && array[i].z == 0;
+
+  std::cout << "\ntable vector shrunk and regrown:           ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool nestedSOVP() {
+  aosoa::table_vector<Cref,tablesize> array(len, soa::parallel_init);
+  std::cout << "\ntable vector with table size " << tablesize << ", initialized in parallel" << std::endl;
+  return test(array);
+}
+
+bool transposeSOV() {
+  std::vector<C> records(len), result(len);
+  for (size_t i=0; i<len; ++i) records[i] = C{i, 2*i, 3*i};
+  aosoa::table_vector<Cref,tablesize> array(len);
+  aosoa::parallel_from_aos(records.data(), array);
+  aosoa::to_aos(array, result.data());
+
+  bool all_fine = true;
+  for (size_t i=0; i<len; ++i)
+	all_fine = all_fine && array[i].y == 2*i && result[i].x == i && result[i].y == 2*i && result[i].z == 3*i;
+
+  std::cout << "\ntable vector from and to AOS:             ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool reblockSOV() {
+  aosoa::table_vector<Cref,tablesize> array(len);
+  for (size_t i=0; i<len; ++i) array[i].x = array[i].y = array[i].z = i;
+  aosoa::table_vector<Cref,7> reblocked(len);
+  aosoa::copy(array, reblocked);
+  soa::dtable<Cref> flat(len);
+  aosoa::parallel_copy(reblocked, flat);
+
+  bool all_fine = true;
+  for (size_t i=0; i<len; ++i)
+	all_fine = all_fine && reblocked[i].y == i && flat[i].x == i && flat[i].z == i;
+
+  std::cout << "\ntable vector copied to other table sizes: ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool variantsSOV() {
+  aosoa::table_vector<Cref,tablesize> array(len);
+  typedef decltype(array[0]) V;
+  aosoa::ivdep_indexed_for_each([](size_t i, V& v) {v.x = i; v.y = 0; v.z = 0;}, array);
+  aosoa::vector_for_each([](V& v) {v.y += v.x;}, array);
+  aosoa::ivdep_for_each([](V& v) {v.y += v.x;}, array);
+  aosoa::vector_ivdep_for_each([](V& v) {v.y += v.x;}, array);
+  aosoa::simd_for_each([](V& v) {v.y += v.x;}, array);
+  aosoa::novector_for_each([](V& v) {v.y += v.x;}, array);
+  aosoa::parallel_simd_for_each([](V& v) {v.z += v.y;}, array);
+  aosoa::parallel_ivdep_indexed_for_each([](size_t i, V& v) {v.z += i;}, array);
+
+  bool all_fine = true;
+  for (size_t i=0; i<len; ++i)
+	all_fine = all_fine && array[i].y == 5*i && array[i].z == 6*i;
+
+  std::cout << "\ntable vector with loop pragma variants:    ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool reduceSOV() {
+  aosoa::table_vector<Cref,tablesize> a0(len);
+  std::vector<size_t> a1(len);
+  typedef decltype(a0[0]) V;
+  aosoa::indexed_for_each([](size_t i, V& v, size_t& w) {v.x = i; v.y = 1; v.z = 0; w = 2;}, a0, a1);
+
+  // the sum of x and the sum of y in one pass.
+  typedef std::pair<size_t,size_t> S;
+  auto add = [](S s, S t) {return S(s.first+t.first, s.second+t.second);};
+  auto sums = aosoa::reduce([](S& s, V& v) {s.first += v.x; s.second += v.y;}, S(0,0), add, a0);
+  auto psums = aosoa::parallel_reduce([](S& s, V& v) {s.first += v.x; s.second += v.y;}, S(0,0), add, a0);
+  auto dot = aosoa::transform_reduce([](V& v, size_t& w) {return v.x*w;}, size_t(0), std::plus<size_t>(), a0, a1);
+  auto pdot = aosoa::parallel_transform_reduce([](V& v, size_t& w) {return v.x*w;}, size_t(0), std::plus<size_t>(), a0, a1);
+
+  // the elements are spread over the lanes, so they do not reach op
+  // in order. for an associative and commutative op, the result does
+  // not depend on the number of lanes, also with fewer elements than
+  // lanes.
+  aosoa::table_vector<Cref,tablesize> b(10);
+  aosoa::indexed_for_each([](size_t i, V& v) {v.x = (i*7)%10; v.y = 0; v.z = 0;}, b);
+  auto largest = [](size_t& m, V& v) {m = std::max(m, v.x);};
+  auto maximum = [](size_t l, size_t r) {return std::max(l, r);};
+  const size_t m1 = aosoa::reduce<1>(largest, size_t(0), maximum, b);
+  const size_t m16 = aosoa::reduce<16>(largest, size_t(0), maximum, b);
+  const size_t dm = aosoa::deterministic_reduce<4>(largest, size_t(0), maximum, b);
+  const size_t pm = aosoa::parallel_reduce<2>(largest, size_t(0), maximum, b);
+
+  const bool all_fine =
+	sums.first == len*(len-1)/2 && sums.second == len && psums == sums &&
+	dot == len*(len-1) && pdot == dot &&
+	m1 == 9 && m16 == 9 && dm == 9 && pm == 9;
+
+  std::cout << "\ntable vector reduced:                      ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool deterministicSOV() {
+  // enough elements for several chunks in the parallel reductions.
+  constexpr size_t n = 5000;
+  aosoa::table_vector<Cref,tablesize> array(n);
+  typedef decltype(array[0]) V;
+  aosoa::indexed_for_each([](size_t i, V& v) {v.x = i; v.y = 0; v.z = 0;}, array);
+
+  // small values that get lost when added to a large one.
+  auto value = [](V& v) {return v.x == 0 ? 1e8f : 1.0f;};
+
+  typedef aosoa::kahan_sum<float> K;
+  typedef aosoa::neumaier_sum<float> N;
+  const auto sum = aosoa::deterministic_transform_reduce(value, 0.0f, std::plus<float>(), array);
+  const auto nsum = aosoa::deterministic_reduce([value](N& s, V& v) {s += value(v);}, N(), std::plus<N>(), array);
+  const auto ksum = aosoa::reduce([value](K& s, V& v) {s += value(v);}, K(), std::plus<K>(), array);
+
+  bool all_fine = ksum.value() == 1e8f + float(n-1) && nsum.value() == 1e8f + float(n-1);
+
+  // the parallel results must not depend on the number of threads.
+  for (int threads : {1, 2, 4}) {
+	tbb::task_arena arena(threads);
+	arena.execute([&] {
+		const auto psum = aosoa::parallel_deterministic_transform_reduce(value, 0.0f, std::plus<float>(), array);
+		const auto pnsum = aosoa::parallel_deterministic_reduce([value](N& s, V& v) {s += value(v);}, N(), std::plus<N>(), array);
+		all_fine = all_fine && psum == sum && pnsum.value() == nsum.value();
+	  });
+  }
+
+  std::cout << "\ntable vector reduced deterministically:    ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool scanSOV() {
+  // enough elements for several chunks in the parallel scans.
+  constexpr size_t n = 5000;
+  aosoa::table_vector<Cref,tablesize> counts(n);
+  aosoa::table_vector<Cref,7> offsets(n);
+  typedef decltype(counts[0]) V;
+  aosoa::indexed_for_each([](size_t i, V& v) {v.x = i%5; v.y = 0; v.z = 0;}, counts);
+
+  const auto total = aosoa::exclusive_scan<0,1>(counts, offsets, size_t(0));
+  const auto ptotal = aosoa::parallel_inclusive_scan<0,2>(counts, offsets);
+  const auto ttotal = aosoa::parallel_transform_exclusive_scan<1>
+	(counts, counts, size_t(0), std::plus<size_t>(), [](V& v) {return 2*v.x;});
+
+  bool all_fine = total == ptotal && 2*total == ttotal;
+  size_t sum = 0;
+  for (size_t i=0; i<n; ++i) {
+	all_fine = all_fine && offsets[i].y == sum && counts[i].y == 2*sum;
+	sum += i%5;
+	all_fine = all_fine && offsets[i].z == sum;
+  }
+  all_fine = all_fine && total == sum;
+
+  std::cout << "\ntable vector counts scanned to offsets:    ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool compactSOV() {
+  // enough elements for several chunks in the parallel versions.
+  constexpr size_t n = 5000;
+  typedef aosoa::table_vector<Cref,tablesize> V0;
+  typedef decltype(std::declval<V0&>()[0]) V;
+  V0 a0(n), a1(n), a2(n), a3(n);
+  aosoa::table_vector<Cref,7> copies(n);
+  for (auto a : {&a0, &a1, &a2, &a3})
+	aosoa::indexed_for_each([](size_t i, V& v) {v.x = i; v.y = 2*i; v.z = 3*i;}, *a);
+
+  auto dead = [](V& v) {return v.x%3 == 0;};
+  auto alive = [](V& v) {return v.x%3 != 0;};
+  const auto size0 = aosoa::remove_if(a0, dead);
+  const auto size1 = aosoa::parallel_remove_if(a1, dead);
+  const auto count2 = aosoa::parallel_stable_partition(a2, alive);
+  const auto count3 = aosoa::stable_partition(a3, alive);
+  const auto count = aosoa::parallel_copy_if(a3, copies, alive);
+
+  bool all_fine =
+	size0 == n-(n+2)/3 && a0.size() == size0 && size1 == size0 && a1.size() == size0 &&
+	count2 == size0 && count3 == size0 && a2.size() == n && count == size0;
+  for (size_t i=0, j=0, k=size0; all_fine && i<n; ++i) {
+	const size_t l = i%3 ? j++ : k++;
+	all_fine = a2[l].x == i && a2[l].y == 2*i && a2[l].z == 3*i && a3[l].z == 3*i;
+	if (i%3) all_fine = all_fine && a0[l].y == 2*i && a1[l].z == 3*i && copies[l].x == i;
+  }
+
+  std::cout << "\ntable vector compacted and partitioned:    ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool sortSOV() {
+  // enough elements for several chunks in the parallel sort.
+  constexpr size_t n = 50000;
+  aosoa::table_vector<Cref,tablesize> a0(n);
+  soa::dtable<Cref> a1(n);
+  typedef decltype(a0[0]) V;
+  auto init = [](size_t i, V& v) {v.x = (n-i)%13; v.y = i; v.z = 3*i;};
+  aosoa::indexed_for_each(init, a0);
+  for (size_t i=0; i<n; ++i) {auto v = a1[i]; init(i, v);}
+
+  aosoa::stable_sort_by_key<0>(a0);
+  aosoa::parallel_sort_by_key<0>(a1);
+
+  bool all_fine = true;
+  for (size_t i=0; all_fine && i<n; ++i) {
+	all_fine = a0[i].x == a1[i].x && a0[i].y == a1[i].y && a0[i].z == 3*a0[i].y && a1[i].z == 3*a1[i].y;
+	if (i > 0) all_fine = all_fine && (a0[i-1].x < a0[i].x || (a0[i-1].x == a0[i].x && a0[i-1].y < a0[i].y));
+  }
+
+  std::cout << "\ntable vector and dtable sorted by key:     ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool gatherSOV() {
+  aosoa::table_vector<Cref,tablesize> array(len);
+  std::vector<size_t> v(len);
+  typedef decltype(array[0]) V;
+  aosoa::indexed_for_each([](size_t i, V& e, size_t& w) {e.x = i; e.y = 2*i; e.z = 3*i; w = 0;}, array, v);
+
+  std::vector<size_t> indices(len);
+  for (size_t k=0; k<len; ++k) indices[k] = (k*7)%len;
+  std::vector<size_t> x(len), z(len);
+  aosoa::gather<0,2>(array, indices, x.data(), z.data());
+  for (auto& e : z) e += 1;
+  aosoa::scatter<2>(array, indices, static_cast<const size_t*>(z.data()));
+  aosoa::indirect_for_each([](V& e, size_t& w) {w += e.y;}, indices, array, v);
+
+  // the tables of a table_deque are spread over several chunks.
+  aosoa::table_deque<Cref,tablesize,2> deque(len);
+  aosoa::indexed_for_each([](size_t i, V& e) {e.x = i; e.y = 2*i; e.z = 3*i;}, deque);
+  std::vector<size_t> dy(len);
+  aosoa::gather<1>(deque, indices, dy.data());
+  for (auto& e : dy) e += 1;
+  aosoa::scatter<0>(deque, indices, static_cast<const size_t*>(dy.data()));
+
+  bool all_fine = true;
+  for (size_t k=0; k<len; ++k) {
+	const size_t i = indices[k];
+	all_fine = all_fine && x[k] == i && array[i].z == 3*i+1 && v[i] == 2*i;
+	all_fine = all_fine && dy[k] == 2*i+1 && deque[i].x == 2*i+1 && deque[i].z == 3*i;
+  }
+
+  std::cout << "\ntable vector gathered and scattered:       ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool pairSOV() {
+  aosoa::table_vector<Cref,tablesize> a0(len), a1(len);
+  aosoa::table_vector<Cref,7> b(len/3);
+  // enough tables for several blocks in the parallel symmetric loop.
+  constexpr size_t n = 3000;
+  aosoa::table_vector<Cref,7> c(n);
+  typedef decltype(a0[0]) V;
+  typedef decltype(b.data()[0]) T;
+  auto init = [](size_t i, V& v) {v.x = i; v.y = 0; v.z = 0;};
+  aosoa::indexed_for_each(init, a0);
+  aosoa::indexed_for_each(init, a1);
+  aosoa::indexed_for_each(init, b);
+  aosoa::indexed_for_each(init, c);
+
+  // y sums x over all other elements, z counts the pairs.
+  aosoa::symmetric_for_each_pair([](V& p, V& q) {p.y += q.x; q.y += p.x; ++p.z; ++q.z;}, a0);
+  aosoa::parallel_symmetric_for_each_pair([](V& p, V& q) {p.y += q.x; q.y += p.x; ++p.z; ++q.z;}, a1);
+  aosoa::parallel_symmetric_for_each_pair([](V& p, V& q) {p.y += q.x; q.y += p.x; ++p.z; ++q.z;}, c);
+  aosoa::for_each_pair([](V& p, V& q) {p.z += q.x;}, b, a0);
+  aosoa::parallel_for_each_pair_range([](V& p, size_t start, size_t end, T& table) {
+	  const size_t* x = std::get<0>(table.columns());
+	  for (size_t j=start; j<end; ++j) p.y += x[j];
+	}, b, b);
+
+  const size_t sum = len*(len-1)/2;
+  const size_t bsum = (len/3)*(len/3-1)/2;
+  bool all_fine = true;
+  for (size_t i=0; i<len; ++i)
+	all_fine = all_fine &&
+	  a0[i].y == sum-i && a0[i].z == len-1 && a1[i].y == a0[i].y && a1[i].z == a0[i].z;
+  for (size_t i=0; i<len/3; ++i)
+	all_fine = all_fine && b[i].z == sum && b[i].y == bsum;
+  for (size_t i=0; i<n; ++i)
+	all_fine = all_fine && c[i].y == n*(n-1)/2-i && c[i].z == n-1;
+
+  std::cout << "\ntable vector pairs:                        ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool packSOV() {
+  typedef aosoa::table_vector<Cref,tablesize> V0;
+  typedef aosoa::table_vector<Cref,7> V1;
+  V0 a0(len);
+  V1 a1(len);
+  for (size_t i=0; i<len; ++i) a0[i].x = a0[i].y = a0[i].z = i;
+  aosoa::pack_for_each<4>([](aosoa::pack<V0,4>& p0, aosoa::pack<V1,4>& p1) {
+	  p0.get<0>() += p0.get<1>() + p0.get<2>();
+	  p1.get<1>() = p0.get<0>() * size_t(2);
+	}, a0, a1);
+
+  bool all_fine = true;
+  for (size_t i=0; i<len; ++i)
+	all_fine = all_fine && a0[i].x == 3*i && a1[i].y == 6*i;
+
+  std::cout << "\ntable vectors processed in packs of 4:     ";
+  if (all_fine) std::cout << "ok\n";
+  else std::cout << "NOT OK!\n";
+  return all_fine;
+}
+
+bool nestedSOVA() {
+  std::vector<size_t> x(len/2), y(len/2), z(len/2);
+  aosoa::table_vector<Cref,tablesize> array(3);
+  array.append_columns(len/2, x.data(), y.data(), z.data());
+  array.append_n(len-len/2-3, [](size_t, Cref& element) {element.x = element.y = element.z = 0;});
+  std::cout << "\ntable vector with table size " << tablesize << ", appended in bulk" << std::endl;
+  return test(array);
+}
+
+bool nestedSOD1() {
+  aosoa::table_deque<Cref,1> array(len);
+  std::cout << "\ntable deque with table size " << 1 << std::endl;
+  return test(array);
+}
+
+bool nestedSODB() {
+  aosoa::table_deque<Cref,tablesize,2> array;
+  for (size_t i=0; i<len; ++i) array.resize(i+1);
+  std::cout << "\ntable deque with table size " << tablesize << ", grown one by one" << std::endl;
+  return test(array);
+}
+
 // multi compatibly tabled
 
 bool mcstdAOS() {
@@ -984,6 +1459,12 @@ bool mcflatDSOA() {
   std::cout << "\nflat dynamic SOA array\n";
   return testmulti(a0, a1, a2);
 }
+
+bool mcflatDSOAS() {
+  soa::dtable<Cref,soa::slab<>> a0(len), a1(len), a2(len);
+  std::cout << "\nflat dynamic SOA array in a slab\n";
+  return testmulti(a0, a1, a2);
+}
 #endif
 
 bool mcnestedSOA1() {
@@ -1028,11 +1509,41 @@ bool mcnestedSOVB() {
   return testmulti(a0, a1, a2);
 }
 
-/*
-// multi incompatibly tabled
+bool mcnestedSODB() {
+  aosoa::table_deque<Cref,tablesize,2> a0(len), a1(len), a2(len);
+  std::cout << "\ntable deque with table size " << tablesize << std::endl;
+  return testmulti(a0, a1, a2);
+}
+
+// multi mixed tabled
+
+#ifdef NO_ITERATORS
+bool mxflatDSOA() {
+  soa::dtable<Cref> a0(len);
+  aosoa::table_vector<Cref,tablesize> a1(len);
+  aosoa::table_vector<Cref,7> a2(len);
+  std::cout << "\nflat dynamic SOA array with table vectors of table sizes " << tablesize << " and " << 7 << std::endl;
+  return testmulti(a0, a1, a2);
+}
+#endif
+
+bool mxnestedSOA() {
+  aosoa::table_array<Cref,tablesize,len> a0;
+  aosoa::table_array<Cref,1,len> a1;
+  aosoa::table_array<Cref,len,len> a2;
+  std::cout << "\ntable arrays with table sizes " << tablesize << ", " << 1 << " and " << len << std::endl;
+  return testmulti(a0, a1, a2);
+}
+
+bool mxnestedSOV() {
+  aosoa::table_vector<Cref,tablesize> a0(len);
+  aosoa::table_vector<Cref,7> a1(len);
+  aosoa::table_deque<Cref,3,2> a2(len);
+  std::cout << "\ntable vectors with table sizes " << tablesize << " and " << 7 << ", table deque with table size " << 3 << std::endl;
+  return testmulti(a0, a1, a2);
+}
 
-For this to work, the xyz_for_each_range templates need to be passed
-generic lambda expressions, which will only be part of C++14.
+// multi incompatibly tabled
 
 bool mistdAOS() {
   std::array<C,len> a0, a2;
@@ -1105,7 +1616,6 @@ bool minestedSOVB() {
   std::cout << "\ntable vector with table size " << tablesize << std::endl;
   return testmulti(a0, a1, a2);
 }
-*/
 
 int main() {
   bool all_fine = true;
@@ -1114,6 +1624,13 @@ int main() {
 #ifdef NO_ITERATORS
   all_fine = flatSOA() && all_fine;
   all_fine = flatDSOA() && all_fine;
+  all_fine = flatDSOAS() && all_fine;
+  all_fine = flatDSOAC() && all_fine;
+  all_fine = flatDSOAG() && all_fine;
+  all_fine = flatDSOAU() && all_fine;
+  all_fine = flatMSOA() && all_fine;
+  all_fine = flatVSOA() && all_fine;
+  all_fine = flatDSOAA() && all_fine;
 #endif
   all_fine = nestedSOA1() && all_fine;
   all_fine = nestedSOAN() && all_fine;
@@ -1123,6 +1640,23 @@ int main() {
   all_fine = nestedSOV1() && all_fine;
   all_fine = nestedSOVN() && all_fine;
   all_fine = nestedSOVB() && all_fine;
+  all_fine = nestedSOVU() && all_fine;
+  all_fine = nestedSOVR() && all_fine;
+  all_fine = nestedSOVP() && all_fine;
+  all_fine = nestedSOVA() && all_fine;
+  all_fine = transposeSOV() && all_fine;
+  all_fine = reblockSOV() && all_fine;
+  all_fine = variantsSOV() && all_fine;
+  all_fine = packSOV() && all_fine;
+  all_fine = reduceSOV() && all_fine;
+  all_fine = deterministicSOV() && all_fine;
+  all_fine = scanSOV() && all_fine;
+  all_fine = compactSOV() && all_fine;
+  all_fine = sortSOV() && all_fine;
+  all_fine = gatherSOV() && all_fine;
+  all_fine = pairSOV() && all_fine;
+  all_fine = nestedSOD1() && all_fine;
+  all_fine = nestedSODB() && all_fine;
 
   std::cout << "\nmulti compatibly tabled\n";
 
@@ -1130,6 +1664,7 @@ int main() {
 #ifdef NO_ITERATORS
   all_fine = mcflatSOA() && all_fine;
   all_fine = mcflatDSOA() && all_fine;
+  all_fine = mcflatDSOAS() && all_fine;
 #endif
   all_fine = mcnestedSOA1() && all_fine;
   all_fine = mcnestedSOAN() && all_fine;
@@ -1139,8 +1674,16 @@ int main() {
   all_fine = mcnestedSOV1() && all_fine;
   all_fine = mcnestedSOVN() && all_fine;
   all_fine = mcnestedSOVB() && all_fine;
+  all_fine = mcnestedSODB() && all_fine;
+
+  std::cout << "\nmulti mixed tabled\n";
+
+#ifdef NO_ITERATORS
+  all_fine = mxflatDSOA() && all_fine;
+#endif
+  all_fine = mxnestedSOA() && all_fine;
+  all_fine = mxnestedSOV() && all_fine;
 
-  /*
   std::cout << "\nmulti incompatibly tabled\n";
 
   all_fine = mistdAOS() && all_fine;
@@ -1156,7 +1699,6 @@ int main() {
   all_fine = minestedSOV1() && all_fine;
   all_fine = minestedSOVN() && all_fine;
   all_fine = minestedSOVB() && all_fine;
-  */
 
   if (all_fine) std::cout << "\ndone\n";
   else std::cout << "\nFAILURES OCCURRED!\n";